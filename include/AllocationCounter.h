@@ -0,0 +1,8 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+//Counts the heap allocations of the whole process, including those of ROOT and of worker threads, by replacing
+//every overload of the global operator new. Linking the AllocationCounter library into an executable is enough
+//to replace them there; it is only used by the tests and benchmarks that check the allocations of hot paths.
+unsigned long GetNAllocations();
+#endif
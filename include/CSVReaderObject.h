@@ -0,0 +1,37 @@
+#ifndef CSVREADEROBJECT_H
+#define CSVREADEROBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads the file in chunks.
+#include <utility> //For std::pair.
+#include <cstddef> //For std::size_t.
+
+//Reads a file of comma separated numbers (the data sets and the model logs) into a list, row after row. The file
+//is read in chunks of ChunkSize bytes, and the numbers are parsed in place with std::from_chars in full double
+//precision. Files larger than a few chunks are parsed NThreads chunks at a time, each chunk on its own thread, so
+//the memory used besides the values is bounded by NThreads chunks. Lines starting with '#' are comments, and empty
+//fields are skipped. Rows that can't be parsed, or whose number of values differs from the first row, are
+//reported with their line number and left out.
+class CSVReaderObject
+{
+ public:
+  static const std::size_t ChunkSize = 1 << 20;
+  CSVReaderObject(std::string FileName, unsigned int NThreads = 0);
+  bool IsOpen() const;
+  unsigned int Read(std::vector<double>& Values, unsigned int NColumns = 0); //Returns the number of columns.
+  unsigned int GetNErrors() const;
+ private:
+  struct Piece //Result of parsing a part of a chunk.
+  {
+    std::vector<double> Values;
+    std::vector< std::pair<unsigned long, std::string> > Errors; //Line within the piece and message.
+    unsigned long NLines;
+  };
+  static void Parse(const char* Begin, const char* End, unsigned int& NColumns, Piece& Out);
+  std::string FileName;
+  std::ifstream Input;
+  unsigned int NThreads;
+  unsigned int NErrors;
+};
+#endif
@@ -0,0 +1,30 @@
+#ifndef COMPILEDFUNCTIONOBJECT_H
+#define COMPILEDFUNCTIONOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+
+//Translates a model formula into a C++ function, builds it into a shared library with the system compiler,
+//and loads it with dlopen. Libraries are cached as CacheDirectory/Formula_<hash>.so, where the hash covers the
+//generated source and the compiler command, so later runs (and other models with the same formula) only load them.
+//The function has the TF1 functor signature, so TF1/TF2 can be built from it without JIT compiling the formula.
+class CompiledFunctionObject
+{
+ public:
+  typedef double (*ScalarFunction)(double* x, double* p);
+  typedef void (*BatchFunction)(const double* X, const double* Y, const double* p, double* Out, unsigned int N);
+  CompiledFunctionObject(std::string Formula, std::string CacheDirectory, std::string Compiler, bool& Success);
+  double operator()(double* x, double* p) const;
+  void Evaluate(const double* X, const double* Y, const double* p, double* Out, unsigned int N) const;
+  ScalarFunction GetFunction() const;
+  unsigned int GetNPar() const;
+  std::string GetLibrary() const;
+  static std::string Translate(std::string Formula, unsigned int& NPar, bool& Success);
+ private:
+  bool Build(const std::string& Source, const std::string& Command) const;
+  bool Load();
+  std::string Library;
+  unsigned int NPar;
+  ScalarFunction Function;
+  BatchFunction Batch;
+};
+#endif
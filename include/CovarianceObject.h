@@ -0,0 +1,51 @@
+#ifndef COVARIANCEOBJECT_H
+#define COVARIANCEOBJECT_H
+//C++ includes.
+#include <vector> //STL vector.
+#include <functional> //For std::function.
+
+class ThreadPool;
+
+//Covariance of one data set, diag(Diagonal) + U*U^T, where U has one row of Rank entries per data point. Sets
+//without a recipe are diagonal (Rank 0); a recipe adds the uncertainty of its P parameters, of rank up to P.
+struct CovarianceBlock
+{
+  std::vector<double> Diagonal;
+  std::vector<double> Factor; //U, row by row.
+  unsigned int Rank;
+};
+
+//Block-diagonal covariance matrix with one diagonal plus low rank block per data set. By the Woodbury identity,
+//V_i^-1 = D^-1 - D^-1*U*K^-1*U^T*D^-1 with K = 1 + U^T*D^-1*U, so only the Rank x Rank matrix K is factorized,
+//and the chi-square r^T*V^-1*r takes time and memory proportional to the sum of n_i*Rank_i rather than n_i^2.
+class CovarianceObject
+{
+ public:
+  CovarianceObject();
+  CovarianceObject(const std::vector<CovarianceBlock>& Blocks, bool& Success);
+  double Chi2(const double* Residuals) const;
+  double Chi2(const double* Residuals, double* Workspace, ThreadPool* Pool = nullptr) const; //Workspace of GetWorkspaceSize().
+  double Chi2(const double* Residuals, double* Workspace, double* Weights, ThreadPool* Pool = nullptr) const; //Also gives V^-1*r, for the gradient.
+  unsigned int GetN() const;
+  unsigned int GetWorkspaceSize() const;
+  unsigned int GetNBlocks() const;
+  unsigned int GetBlockOffset(unsigned int Block) const;
+  unsigned int GetBlockSize(unsigned int Block) const;
+  unsigned int GetRank(unsigned int Block) const;
+  double GetCondition(unsigned int Block) const;
+ private:
+  bool Factorize(const CovarianceBlock& Block, unsigned int Index);
+  void ForEachBlock(const std::function<void(unsigned int)>& Body, ThreadPool* Pool) const;
+  void Solve(unsigned int Block, const double* Residuals, double* Workspace, double* Weights) const;
+  unsigned int N;
+  unsigned int WorkspaceSize;
+  std::vector<unsigned int> Offsets; //First data point of each block.
+  std::vector<unsigned int> Sizes; //Number of data points in each block.
+  std::vector<unsigned int> Ranks;
+  std::vector<unsigned int> ScratchOffsets; //Where each block keeps Rank values in the workspace.
+  std::vector<double> Conditions; //Upper bound on the condition number of each block.
+  std::vector< std::vector<double> > InverseDiagonals;
+  std::vector< std::vector<double> > Factors; //U of each block, row by row.
+  std::vector< std::vector<double> > Capacitances; //Cholesky factor of K of each block, lower triangle packed row by row.
+};
+#endif
@@ -0,0 +1,38 @@
+#ifndef DATACACHEOBJECT_H
+#define DATACACHEOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <cstdint> //Fixed width integers of the file format.
+#include <cstddef> //For std::size_t.
+
+//Binary copy of a parsed data set, stored next to it as <set>.csv.cache so that later runs map it into memory
+//instead of parsing the CSV. It holds the 9 columns (x, its errors, y, its errors, z, its errors) after the
+//default uncertainties and LowField were applied, each as NRows contiguous doubles after an 80 byte header:
+//  char[8] "MFDATA1", uint32 Version, uint32 NColumns, uint64 NRows, int64 CSV mtime, uint64 CSV size,
+//  uint64 CSV hash, double[4] DefaultYieldUncertainty, DefaultEnergyUncertainty, DefaultFieldUncertainty, LowField.
+//The cache is used if the version and defaults match and the hash of the CSV does, since an edit may keep the
+//mtime and size. Hashing the file is still much faster than parsing it. Only CSVs read without errors are saved.
+class DataCacheObject
+{
+ public:
+  static const unsigned int NColumns = 9;
+  DataCacheObject(std::string CSVName, const std::vector<double>& Defaults);
+  ~DataCacheObject();
+  bool Load();
+  bool Save(const std::vector< std::vector<double> >& Columns);
+  uint64_t GetNRows() const;
+  const double* GetColumn(unsigned int Column) const;
+ private:
+  DataCacheObject(const DataCacheObject&);
+  DataCacheObject& operator=(const DataCacheObject&);
+  bool Stat(int64_t& MTime, uint64_t& Size) const;
+  uint64_t HashCSV() const;
+  std::string CSVName;
+  std::string CacheName;
+  std::vector<double> Defaults;
+  void* Mapping; //The mapped cache file, or nullptr.
+  std::size_t MappingSize;
+  uint64_t NRows;
+};
+#endif
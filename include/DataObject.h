@@ -10,31 +10,49 @@
 #include <string> //Basic string.
 #include <memory> //For using shared_ptr.
 #include <fstream> //For using file input/output.
+#include <map> //STL map.
 
 //Custom includes.
 #include "FunctionObject.h" //Modularizes the input of model functions from a .txt file.
+#include "CovarianceObject.h" //Factorized covariance for evaluating the chi-square.
+#include "CompiledFunctionObject.h" //Recipe model built into a shared library.
+
+//Fit result of a model used as a recipe, in full precision. Without one, the recipe is read from the
+//<ModelType><ModelID>Log.txt written by BasicModel::SaveParameters().
+struct RecipeResult
+{
+  std::vector<double> Parameters;
+  std::vector<double> Covariance; //Row by row.
+};
 
 class DataObject
 {
  public:
-  DataObject(std::vector<std::string> Sets, std::vector<std::string> Recipes, double DefaultYieldUncertainty, double DefaultEnergyUncertainty, double DefaultFieldUncertainty, double LowField);
-  TMatrixT<double> GetCovariance();
-  std::vector<double> GetDataX();
-  std::vector<double> GetDataXErrLow();
-  std::vector<double> GetDataXErrHigh();
-  std::vector<double> GetDataY();
-  std::vector<double> GetDataYErrLow();
-  std::vector<double> GetDataYErrHigh();
-  std::vector<double> GetDataZ();
-  std::vector<double> GetDataZErrLow();
-  std::vector<double> GetDataZErrHigh();
+  DataObject(std::vector<std::string> Sets, std::vector<std::string> Recipes, double DefaultYieldUncertainty, double DefaultEnergyUncertainty, double DefaultFieldUncertainty, double LowField, std::string FunctionDefinitions, std::string FormulaCache = "", std::string FormulaCompiler = "c++", std::map<std::string, RecipeResult> RecipeResults = std::map<std::string, RecipeResult>(), bool UseDataCache = false);
+  DataObject(const DataObject& Nominal, const std::vector<unsigned int>& Multiplicity); //Resampled copy, e.g. a bootstrap replica.
+  const std::vector<CovarianceBlock>& GetCovarianceBlocks() const;
+  const CovarianceObject& GetCovarianceFactor() const;
+  bool IsValid() const;
+  const std::vector<double>& GetDataX() const;
+  const std::vector<double>& GetDataXErrLow() const;
+  const std::vector<double>& GetDataXErrHigh() const;
+  const std::vector<double>& GetDataY() const;
+  const std::vector<double>& GetDataYErrLow() const;
+  const std::vector<double>& GetDataYErrHigh() const;
+  const std::vector<double>& GetDataZ() const;
+  const std::vector<double>& GetDataZErrLow() const;
+  const std::vector<double>& GetDataZErrHigh() const;
   friend std::ostream &operator<< (std::ostream &out, const DataObject &Obj);
+  friend struct DataObjectBench; //Times ReadData and BuildCovariance, see src/MinuitFitBench.cpp.
  private:
   DataObject();
-  TMatrixT<double> BuildCovariance(std::vector< std::vector<double> > Data, TMatrixT<double> V_P);
+  CovarianceBlock BuildCovariance(const std::vector< std::vector<double> >& Data, const TMatrixT<double>& V_P);
+  static std::vector<double> Cholesky(const TMatrixT<double>& V, unsigned int P);
   double Derivative(double* x, double* p, int axis);
-  int ReadData(std::ifstream &Input, std::vector<double> &List);
-  TMatrixT<double> Covariance;
+  int ReadData(std::string FileName, std::vector<double> &List, unsigned int Columns = 0, unsigned int* NErrors = nullptr); //NErrors gets the number of rows left out.
+  std::vector<CovarianceBlock> CovarianceBlocks; //The covariance is block diagonal, with one block per data set.
+  CovarianceObject CovarianceFactor;
+  bool Valid;
   std::vector<double> DataX;
   std::vector<double> DataXErrLow;
   std::vector<double> DataXErrHigh;
@@ -46,6 +64,7 @@ class DataObject
   std::vector<double> DataZErrHigh;
   std::shared_ptr<FunctionObject> FuncObject;
   std::shared_ptr<TF2> RecipeModel;
+  std::shared_ptr<CompiledFunctionObject> CompiledRecipe; //Only used if a FormulaCache directory is given.
 };
 
 
@@ -0,0 +1,26 @@
+#ifndef DEFINITIONSOBJECT_H
+#define DEFINITIONSOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <unordered_map> //Index of the definitions.
+#include <memory> //For using shared_ptr.
+
+//The entries of a model definitions file (Key:"Value" lines), indexed by their exact key, e.g. "NRQYF1" for
+//the function of ModelType NRQY and ModelID 1. Each file is parsed once per process: Get() returns the same
+//object to every caller, so models and data sets of a batch run don't rescan it.
+class DefinitionsObject
+{
+ public:
+  static std::shared_ptr<const DefinitionsObject> Get(std::string FileName);
+  bool IsOpen() const;
+  bool Find(const std::string& Key, std::string& Value) const;
+  bool Find(const std::string& ModelType, const std::string& Field, unsigned int ModelID, std::string& Value) const;
+  std::vector<unsigned int> FindModelIDs(const std::string& ModelType) const;
+ private:
+  DefinitionsObject(std::string FileName);
+  std::unordered_map<std::string, std::string> Entries;
+  std::vector<std::string> Keys; //In file order.
+  bool Open;
+};
+#endif
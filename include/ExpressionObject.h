@@ -0,0 +1,89 @@
+#ifndef EXPRESSIONOBJECT_H
+#define EXPRESSIONOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+
+//Custom includes.
+#include "VectorKernels.h" //Element-wise kernels the compiled formula is executed with.
+
+//Compiles a model formula (the subset of TFormula used in the definitions file: numbers, x, y, [n], + - * / ^,
+//and TMath::Power, Exp, Log, Sqrt, Abs) for evaluation over many data points at once. Sub-expressions that
+//only depend on the parameters are evaluated once per call, and the rest is run in blocks of BlockSize points
+//through VectorKernels. Every operation is done in double, so a division of two integer literals (e.g. "1/2",
+//which is 0 in C++ and TFormula) is not supported. Formulas outside of that subset, or with such a division,
+//set Success to false, so that the caller can keep TFormula.
+class ExpressionObject
+{
+ public:
+  static const unsigned int BlockSize = 256; //Points per block; a block of every slot stays in the L2 cache.
+  ExpressionObject(std::string Expression, bool& Success);
+  void Evaluate(const double* X, const double* Y, const double* p, double* Out, unsigned int N, double* Workspace) const;
+  double Evaluate(double X, double Y, const double* p) const;
+  void EvaluateWithDerivatives(const double* X, const double* Y, const double* p, double* Out, double* OutX, double* OutY, unsigned int N, double* Workspace) const;
+  void WeightedGradient(const double* X, const double* Y, const double* p, const double* Weights, double* Gradient, unsigned int N, double* Workspace) const;
+  unsigned int GetNPar() const;
+  unsigned int GetWorkspaceSize() const;
+  unsigned int GetGradientWorkspaceSize() const;
+  bool UsesY() const;
+ private:
+  enum Operation { Constant, Parameter, VariableX, VariableY, Add, Subtract, Multiply, Divide, Power, Negate, Exponential, Logarithm, SquareRoot, Absolute, Square };
+  enum OperandKind { Slot, Uniform, ArrayX, ArrayY };
+  struct Node
+  {
+    Operation Op;
+    int Left; //Index of the operands in Nodes, -1 if unused.
+    int Right;
+    double Value; //Constant value or parameter index.
+    bool Uniform; //True if it does not depend on x or y.
+    bool Integer; //An int constant in C++, e.g. "2" or "2*3".
+  };
+  struct UniformStep //Scalar step, run once per call.
+  {
+    Operation Op;
+    unsigned int Left;
+    unsigned int Right;
+    double Value;
+  };
+  struct Operand
+  {
+    OperandKind Kind;
+    unsigned int Index; //Slot or uniform index.
+    int Node; //Node it was compiled from, for its parameter dependencies.
+  };
+  struct VectorStep //Kernel call, run once per block.
+  {
+    Operation Op;
+    Operand A;
+    Operand B;
+    unsigned int Out; //Slot of the result.
+    int Node;
+  };
+  //Recursive descent parser, following the C++ operator precedence TFormula uses.
+  int ParseSum(const std::string& Text, std::size_t& Position);
+  int ParseProduct(const std::string& Text, std::size_t& Position);
+  int ParseUnary(const std::string& Text, std::size_t& Position);
+  int ParsePower(const std::string& Text, std::size_t& Position);
+  int ParsePrimary(const std::string& Text, std::size_t& Position);
+  int AddNode(Operation Op, int Left, int Right, double Value, bool Integer = false);
+  unsigned int CompileUniform(int Index);
+  Operand Compile(int Index, std::vector<unsigned int>& FreeSlots);
+  unsigned int NewSlot(std::vector<unsigned int>& FreeSlots);
+  double EvaluateNode(int Index, double X, double Y, const double* p) const;
+  const double* Resolve(const Operand& Op, const double* X, const double* Y, const double* Uniforms, const double* Slots, unsigned int Start) const;
+  void Run(const VectorStep& Step, const double* X, const double* Y, const double* Uniforms, double* Slots, unsigned int Start, unsigned int n) const;
+  void EvaluateUniforms(const double* p, double* Uniforms) const;
+  static double Apply(Operation Op, double a, double b);
+  static double Derivative(Operation Op, double a, double b, double c, double da, double db);
+  std::vector<Node> Nodes;
+  std::vector< std::vector<unsigned int> > Dependencies; //Parameters each node depends on, in increasing order.
+  std::vector<UniformStep> UniformSteps;
+  std::vector<VectorStep> VectorSteps;
+  int Root; //Node of the whole expression.
+  Operand Result;
+  unsigned int NPar;
+  unsigned int NSlots;
+  bool HasY;
+  const VectorKernels* Kernels;
+};
+#endif
@@ -0,0 +1,21 @@
+#ifndef FITCACHEOBJECT_H
+#define FITCACHEOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+
+//Stores fit results in Directory/Fit_<Key>.txt, where the key is a hash of everything the fit depends on
+//(see BasicModel::CacheKey()), so a later run with the same inputs can read the result instead of minimizing.
+//The values are written with enough digits to be read back exactly.
+class FitCacheObject
+{
+ public:
+  FitCacheObject(std::string Directory, std::string Key);
+  bool Load(double& Chisquare, double& EDM, unsigned int& NFree, std::vector<double>& Parameters, std::vector<double>& Errors, std::vector<double>& Covariance) const;
+  bool Save(double Chisquare, double EDM, unsigned int NFree, const std::vector<double>& Parameters, const std::vector<double>& Errors, const std::vector<double>& Covariance) const;
+  std::string GetFileName() const;
+ private:
+  std::string Directory;
+  std::string FileName;
+};
+#endif
@@ -0,0 +1,30 @@
+#ifndef FITRESULTOBJECT_H
+#define FITRESULTOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+
+//Result of a fit, written by BasicModel::Minimize() as <ModelType><ModelID>Fit.txt so that plots can be drawn
+//later, elsewhere, without fitting again (see MinuitFitPlot). The file has the Key:"Value" lines of the other
+//input files, in the order they were set, and describes itself: the formula, the parameters with their errors
+//and covariance, the chi-square and EDM, and which data (and a hash of its contents) the fit used.
+//Numbers are written with enough digits to be read back exactly.
+class FitResultObject
+{
+ public:
+  FitResultObject();
+  bool Load(std::string FileName);
+  bool Save(std::string FileName) const;
+  void Set(const std::string& Key, const std::string& Value);
+  void Set(const std::string& Key, double Value);
+  void Set(const std::string& Key, const std::vector<double>& Values);
+  bool Has(const std::string& Key) const;
+  std::string Get(const std::string& Key) const; //Empty if the key is missing.
+  double GetNumber(const std::string& Key) const;
+  std::vector<double> GetNumbers(const std::string& Key) const;
+ private:
+  std::map<std::string, std::string> Entries;
+  std::vector<std::string> Keys; //In the order they were set.
+};
+#endif
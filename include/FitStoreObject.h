@@ -0,0 +1,86 @@
+#ifndef FITSTOREOBJECT_H
+#define FITSTOREOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <functional> //Filters of Select().
+#include <cstdint> //Fixed width integers of the file format.
+#include <cstddef> //For std::size_t.
+
+//Results of every fit, appended as one record each to a pair of binary files so that many thousands of fits
+//can be filtered and ranked without parsing text. <Name>.idx holds the scalars of each record at a fixed
+//stride after a 16 byte header (char[8] "MFSTORE", uint32 Version, uint32 RecordSize), in the byte order of
+//the machine:
+//  char[24] ModelType, uint32 ModelID, uint32 NPar, uint64 FormulaHash, uint64 DataHash, double Chisquare,
+//  double EDM, int32 Status, uint32 NFree, uint32 NData, uint32 Flags (1 converged, 2 from the fit cache),
+//  uint64 NCalls, double FitTime, int64 Time (seconds since the epoch), uint64 Offset.
+//<Name>.dat holds the NPar parameters, NPar errors and NPar*NPar covariance (row by row) of each record as
+//doubles, starting Offset bytes into the file. Records are appended under a file lock, so fits running in
+//other threads or processes may share a store. Load() reads the index into one vector per column, and the
+//arrays of a record are only read when asked for.
+class FitStoreObject
+{
+ public:
+  struct Record
+  {
+    std::string ModelType;
+    unsigned int ModelID;
+    uint64_t FormulaHash;
+    uint64_t DataHash;
+    double Chisquare;
+    double EDM;
+    int Status;
+    unsigned int NFree;
+    unsigned int NData;
+    bool Converged;
+    bool FromCache;
+    unsigned long NCalls;
+    double FitTime;
+    std::vector<double> Parameters;
+    std::vector<double> Errors;
+    std::vector<double> Covariance;
+  };
+  FitStoreObject(std::string Name);
+  bool Append(const Record& Entry) const;
+  bool Load();
+  std::size_t GetNRecords() const;
+  std::vector<std::size_t> Select(const std::function<bool(std::size_t Index)>& Filter) const;
+  void Rank(std::vector<std::size_t>& Indices, const std::vector<double>& Column) const; //Increasing, ties in store order.
+  bool GetArrays(std::size_t Index, std::vector<double>& Parameters, std::vector<double>& Errors, std::vector<double>& Covariance) const;
+  const std::vector<std::string>& GetModelTypes() const;
+  const std::vector<unsigned int>& GetModelIDs() const;
+  const std::vector<unsigned int>& GetNPars() const;
+  const std::vector<uint64_t>& GetFormulaHashes() const;
+  const std::vector<uint64_t>& GetDataHashes() const;
+  const std::vector<double>& GetChisquares() const;
+  const std::vector<double>& GetEDMs() const;
+  const std::vector<int>& GetStatuses() const;
+  const std::vector<unsigned int>& GetNFrees() const;
+  const std::vector<unsigned int>& GetNDatas() const;
+  const std::vector<unsigned int>& GetFlags() const;
+  const std::vector<unsigned long>& GetNCalls() const;
+  const std::vector<double>& GetFitTimes() const;
+  const std::vector<int64_t>& GetTimes() const;
+ private:
+  static const uint32_t Version = 1;
+  static const uint32_t RecordSize = 112;
+  static const std::size_t ModelTypeSize = 24;
+  std::string IndexName;
+  std::string DataName;
+  std::vector<std::string> ModelTypes; //Columns of the loaded index.
+  std::vector<unsigned int> ModelIDs;
+  std::vector<unsigned int> NPars;
+  std::vector<uint64_t> FormulaHashes;
+  std::vector<uint64_t> DataHashes;
+  std::vector<double> Chisquares;
+  std::vector<double> EDMs;
+  std::vector<int> Statuses;
+  std::vector<unsigned int> NFrees;
+  std::vector<unsigned int> NDatas;
+  std::vector<unsigned int> Flags;
+  std::vector<unsigned long> NCalls;
+  std::vector<double> FitTimes;
+  std::vector<int64_t> Times;
+  std::vector<uint64_t> Offsets; //Of the arrays in the data file.
+};
+#endif
@@ -3,12 +3,14 @@
 //C++ includes.
 #include <string>
 #include <vector>
-#include <map>
 
 //ROOT includes.
 
 //Custom includes.
 
+//Definition of one model (function, initial parameters, limits and step sizes) and the sets and recipes of its
+//ModelType, looked up by exact key in the process-wide DefinitionsObject. Success is false if any of them is
+//missing, if the vectors don't have one entry per parameter, or if the function uses more parameters than P has.
 class FunctionObject
 {
  public:
@@ -20,6 +22,8 @@ class FunctionObject
   std::vector<double> GetStepSizes();
   std::vector<std::string> GetSets();
   std::vector<std::string> GetRecipes();
+  static std::vector<unsigned int> FindModelIDs(std::string Definitions, std::string SearchString);
+  static unsigned int CountParameters(const std::string& Formula);
  private:
   std::string Function;
   std::vector<double> Parameters;
@@ -28,6 +32,5 @@ class FunctionObject
   std::vector<double> StepSizes;
   std::vector<std::string> Sets;
   std::vector<std::string> Recipes;
-  std::map<std::string,std::string> DefinitionsMap;
 };
 #endif
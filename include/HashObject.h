@@ -0,0 +1,24 @@
+#ifndef HASHOBJECT_H
+#define HASHOBJECT_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <cstdint> //Fixed width integer for the hash.
+#include <cstddef> //For std::size_t.
+
+//64-bit FNV-1a hash, built up from pieces. Used instead of std::hash, which is not guaranteed to be the same
+//between runs or standard libraries, to name files that later runs must find again.
+class HashObject
+{
+ public:
+  HashObject();
+  void Add(const char* Data, std::size_t Size);
+  void Add(const std::string& Text);
+  void Add(const std::vector<double>& Values);
+  bool AddFile(const std::string& FileName); //False if the file can't be read.
+  uint64_t Get() const;
+  std::string GetHex() const;
+ private:
+  uint64_t Value;
+};
+#endif
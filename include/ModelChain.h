@@ -0,0 +1,56 @@
+#ifndef MODELCHAIN_H
+#define MODELCHAIN_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <mutex> //For using std::mutex.
+#include <condition_variable> //Wakes up Run() when every model is done.
+
+//Custom includes.
+#include "Models.h" //The model objects being fit.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "ThreadPool.h" //Runs the independent models concurrently.
+
+namespace NESTModel
+{
+  //Fits a model together with every model its recipes depend on (e.g. ERQY uses the fit of ERTY0 for its
+  //ERLightYield set). The recipes form a directed acyclic graph, which is fit in topological order: a model
+  //is started as soon as all of its recipes are fit, so independent branches run concurrently. Each result is
+  //passed to the models using it in memory, in full precision, and also saved to its log as usual. Recipe
+  //models without data sets of their own are read from their existing log.
+  class ModelChain
+  {
+  public:
+    ModelChain(std::string modeltype, unsigned int id, unsigned int nthreads = 0);
+    bool Run();
+  private:
+    struct Node
+    {
+      std::string Type;
+      unsigned int ID;
+      std::vector<unsigned int> Recipes; //Nodes this one depends on.
+      std::vector<unsigned int> Users; //Nodes depending on this one.
+      bool External; //Not fit here: its log is used.
+      bool Done;
+      bool Failed;
+      std::shared_ptr<BasicModel> Model;
+    };
+    int AddNode(std::string Type, unsigned int ID, std::vector<std::string>& Path);
+    void Fit(unsigned int Index);
+    void Finish(unsigned int Index, bool Failed);
+    std::string ModelType;
+    unsigned int ID;
+    unsigned int NThreads;
+    std::shared_ptr<SettingsObject> Settings;
+    std::vector<Node> Nodes;
+    std::map<std::string, unsigned int> NodeIndex; //Node of each "<ModelType><ModelID>".
+    std::vector<unsigned int> Pending; //Recipes of each node that are not done yet.
+    unsigned int NDone;
+    std::shared_ptr<ThreadPool> Pool;
+    std::mutex StateMutex; //Guards Pending, NDone, and the flags of the nodes.
+    std::condition_variable AllDone;
+  };
+}
+#endif
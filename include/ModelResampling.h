@@ -0,0 +1,47 @@
+#ifndef MODELRESAMPLING_H
+#define MODELRESAMPLING_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <memory> //For using shared_ptr.
+#include <iostream> //Basic input and output.
+#include <fstream> //Replicas are streamed to a file.
+#include <mutex> //For using std::mutex.
+
+//Custom includes.
+#include "Models.h" //The model objects being fit.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+
+namespace NESTModel
+{
+  //Estimates the parameter uncertainties of one model by refitting resampled data: bootstrap replicas, which
+  //redraw the points of each data set with replacement, or the jackknife, which leaves out one data set at a time.
+  //The replicas are fit concurrently, each warm started from the nominal best fit, and each line of the output
+  //file is written as soon as its replica finishes, so that only running replicas are held in memory.
+  class ModelResampling
+  {
+  public:
+    enum Method { Bootstrap, Jackknife };
+    ModelResampling(std::string modeltype, unsigned int id, Method method, unsigned int nthreads = 0);
+    bool Run();
+    void PrintSummary(std::ostream& out);
+    friend struct ResamplingTest; //Checks Multiplicity(), see tests/ResamplingTest.cpp.
+  private:
+    std::vector<unsigned int> Multiplicity(unsigned int Replica);
+    void Record(unsigned int Replica, BasicModel& Model);
+    std::string ModelType;
+    unsigned int ID;
+    Method Mode;
+    unsigned int NThreads;
+    unsigned int NReplicas;
+    unsigned long Seed; //Replica r draws from its own generator, seeded with (Seed, r).
+    std::shared_ptr<SettingsObject> Settings;
+    std::shared_ptr<BasicModel> Nominal;
+    std::ofstream Output;
+    std::mutex OutputMutex; //Guards Output and the running sums, which every replica updates when it finishes.
+    unsigned int NConverged;
+    std::vector<double> Means; //Running mean and sum of squared deviations of each parameter (Welford's method).
+    std::vector<double> SumSquares;
+  };
+}
+#endif
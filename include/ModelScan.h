@@ -0,0 +1,55 @@
+#ifndef MODELSCAN_H
+#define MODELSCAN_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <memory> //For using shared_ptr.
+#include <fstream> //Cells are streamed to a file.
+#include <mutex> //For using std::mutex.
+#include <atomic> //Next cell to be handed out.
+#include <cstdint> //Fixed width integers of the output format.
+
+//Custom includes.
+#include "Models.h" //The model objects being fit.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+
+namespace NESTModel
+{
+  //Evaluates the chi-square of one model over a grid of some of its parameters ("ScanParameters"), with the
+  //other parameters either fixed at the best fit or profiled (minimized again in every cell). Threads take
+  //the next batch of cells from a shared counter whenever they are done with theirs, so slow (profiled) cells
+  //don't hold the others back, and write them to Scan_<ModelType><ModelID>.bin in batches, so the grid is
+  //never held in memory. The file is binary, in the byte order of the machine:
+  //  header: char[8] "MFSCAN1", uint32 NDims, uint32 NPar, uint32 Profiled, then for each scanned
+  //          parameter uint32 Index, uint32 NPoints, double Low, double High;
+  //  cells:  uint64 Cell, double Chi2 (NaN if the profile failed), and the NPar parameters if Profiled.
+  //Cells are in the order they finished. Cell = k_0 + n_0*(k_1 + n_1*(...)), where k_d is the point of the
+  //d-th scanned parameter, at Low + (High - Low)*k_d/(n_d - 1).
+  class ModelScan
+  {
+  public:
+    ModelScan(std::string modeltype, unsigned int id, unsigned int nthreads = 0);
+    bool Run();
+    friend struct ScanTest; //Checks CellParameters(), see tests/ScanTest.cpp.
+  private:
+    void Work(std::shared_ptr<BasicModel> Model);
+    void CellParameters(uint64_t Cell, std::vector<double>& p);
+    void Flush(std::vector<char>& Buffer);
+    std::string ModelType;
+    unsigned int ID;
+    unsigned int NThreads;
+    bool Profile;
+    std::vector<unsigned int> Scanned; //Index of each scanned parameter.
+    std::vector<double> Low;
+    std::vector<double> High;
+    std::vector<unsigned int> NPoints;
+    uint64_t NCells;
+    std::atomic<uint64_t> NextCell;
+    std::vector<double> BestFit; //Values of the parameters that are not scanned, and start of the profiles.
+    std::shared_ptr<SettingsObject> Settings;
+    std::shared_ptr<const DataObject> Data;
+    std::ofstream Output;
+    std::mutex OutputMutex;
+  };
+}
+#endif
@@ -0,0 +1,34 @@
+#ifndef MODELSWEEP_H
+#define MODELSWEEP_H
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <memory> //For using shared_ptr.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "Models.h" //The model objects being fit.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "DataObject.h" //Modularizes the input of data sets from .txt files.
+
+namespace NESTModel
+{
+  //Fits every ModelID defined for a ModelType within one process. The data sets and their covariance
+  //are loaded once and shared read-only between the models, which are minimized concurrently.
+  class ModelSweep
+  {
+  public:
+    ModelSweep(std::string modeltype, unsigned int nthreads = 0);
+    bool Run();
+    void PrintRanking(std::ostream& out);
+    static bool PrintStoreRanking(std::string modeltype, std::ostream& out);
+    std::vector< std::shared_ptr<BasicModel> >& GetModels();
+  private:
+    std::string ModelType;
+    unsigned int NThreads;
+    std::shared_ptr<SettingsObject> Settings;
+    std::shared_ptr<const DataObject> Data;
+    std::vector< std::shared_ptr<BasicModel> > Models;
+  };
+}
+#endif
@@ -5,9 +5,13 @@
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <functional>
+#include <map>
+#include <atomic>
 
 //ROOT includes.
-#include "TMinuit.h"
+#include "Math/Minimizer.h"
+#include "Math/IFunction.h"
 #include "TMath.h"
 #include "TF2.h"
 #include "TF1.h"
@@ -16,49 +20,114 @@
 //Custom Includes
 #include "SettingsObject.h"
 #include "FunctionObject.h"
+#include "DataObject.h"
+#include "ExpressionObject.h"
+#include "CompiledFunctionObject.h"
+#include "ThreadPool.h"
+#include "HashObject.h"
 
 namespace NESTModel
 {
+  class ModelFCN;
+  class ModelGradFCN;
+
   class BasicModel
   {
   public:
+    static const unsigned int ChunkSize = 16*ExpressionObject::BlockSize; //Data points per task of a parallel evaluation.
     BasicModel(std::string modeltype, unsigned int id = 0);
+    BasicModel(std::string modeltype, unsigned int id, std::shared_ptr<SettingsObject> settings, std::shared_ptr<const DataObject> data);
+    static std::shared_ptr<const DataObject> LoadData(std::shared_ptr<SettingsObject> settings, std::string modeltype, unsigned int id, std::map<std::string, RecipeResult> recipes = std::map<std::string, RecipeResult>());
     double operator()(double* x, double* p);
     double DerivativeX(double* x, double* p);
     double DerivativeY(double* x, double* p);
+    void Evaluate(const double* X, const double* Y, const double* p, double* Out, unsigned int N);
+    double Objective(const double* p);
+    double Chi2(const double* p);
+    double Chi2Covariance(const double* p);
+    double Chi2Covariance(const double* p, double* Gradient);
+    bool HasGradient();
     bool Minimize();
+    bool Minimize(const std::vector<double>& Start);
+    bool Minimize(const std::vector<double>& Start, const std::vector<unsigned int>& Fixed);
     void PrintResults();
     void SaveParameters();
     void DrawGraphs();
+    void SetPlotBins(unsigned int First, unsigned int Last); //DrawGraphs() then only saves the images of these field bins.
+    bool SaveContours();
+    bool SaveFitResult();
+    bool LoadFitResult(std::string FileName, bool AllowDataChange = false);
+    bool StoreFit();
     void SetDefaultField(double Field);
-    TMatrixT<double>& GetCovariance();
-    TMatrixT<double>& GetInvCovariance();
+    const std::vector<CovarianceBlock>& GetCovarianceBlocks();
+    const CovarianceObject& GetCovarianceFactor();
+    std::shared_ptr<const DataObject> GetData();
+    std::shared_ptr<SettingsObject> GetSettings();
     int GetNPar();
     int GetNData();
+    std::string GetModelType();
+    unsigned int GetID();
+    bool IsDefined();
+    bool IsConverged();
+    double GetChisquare();
+    double GetEDM();
+    double GetFitTime();
+    int GetStatus();
+    unsigned long GetNCalls();
+    unsigned int GetNStarts();
+    unsigned int GetBestStart();
     std::vector<double>& GetParameters();
     std::vector<double>& GetParameterErrors();
-    std::vector<double>& GetDataX();
-    std::vector<double>& GetDataXErrLow();
-    std::vector<double>& GetDataXErrHigh();
-    std::vector<double>& GetDataY();
-    std::vector<double>& GetDataYErrLow();
-    std::vector<double>& GetDataYErrHigh();
-    std::vector<double>& GetDataZ();
-    std::vector<double>& GetDataZErrLow();
-    std::vector<double>& GetDataZErrHigh();
+    const std::vector<double>& GetCovariance();
+    const std::vector<double>& GetDataX();
+    const std::vector<double>& GetDataXErrLow();
+    const std::vector<double>& GetDataXErrHigh();
+    const std::vector<double>& GetDataY();
+    const std::vector<double>& GetDataYErrLow();
+    const std::vector<double>& GetDataYErrHigh();
+    const std::vector<double>& GetDataZ();
+    const std::vector<double>& GetDataZErrLow();
+    const std::vector<double>& GetDataZErrHigh();
+    friend struct MultiStartTest; //Checks SampleStarts(), see tests/MultiStartTest.cpp.
     
   private:
+    void Initialize(std::shared_ptr<const DataObject> data);
+    bool LoadWarmStart(std::string Model);
+    bool CanVectorize();
+    bool RunMinimizer(const std::vector<double>& Start, unsigned int MaxCalls, bool Hesse, const std::vector<unsigned int>& Fixed = std::vector<unsigned int>());
+    std::string CacheKey();
+    void HashData(HashObject& Hash);
+    std::string DataKey();
+    void RecordFit();
+    std::vector<double> MultiStart(unsigned int RequestedStarts);
+    std::vector< std::vector<double> > SampleStarts(unsigned int RequestedStarts);
+    void RunChunks(unsigned int N, const std::function<void(unsigned int Chunk, unsigned int Begin, unsigned int End, double* Workspace)>& Body);
+    void PlotFieldBins(unsigned int NBins, const std::function<void(unsigned int Bin)>& Plot);
     unsigned int ID;
     unsigned int NData;
     unsigned int NPar;
     double DefaultField;
     bool Success;
     bool Is2DFit;
+    bool Converged;
+    bool UseCovariance; //Minimize Chi2Covariance rather than the effective variance Chi2.
     double Chisquare;
     double EDM;
-    TMatrixT<double> Covariance;
-    TMatrixT<double> InvCovariance;
-    std::shared_ptr<TMinuit> MinuitMinimizer;
+    double FitTime;
+    int Status; //Status of the last minimization as given by Minuit2, 0 if read from the fit cache.
+    unsigned int NFree; //Number of parameters that were not fixed.
+    bool FromCache; //The results were read from the fit cache rather than minimized.
+    unsigned int NStarts; //Starting points of the minimization, see MultiStart().
+    unsigned int BestStart; //Start the final minimization was refined from, 0 being P itself.
+    unsigned long StartCalls; //Evaluations made by the models minimizing the starts.
+    std::string FitResultFile; //Fit result last saved or loaded, from which the plotting workers build this model.
+    bool FitResultDataChanged; //The data changed since FitResultFile was written.
+    bool PlotWorker; //Only the field bins PlotBinFirst to PlotBinLast are drawn, see SetPlotBins().
+    unsigned int PlotBinFirst;
+    unsigned int PlotBinLast;
+    std::shared_ptr<ROOT::Math::Minimizer> Minimizer;
+    std::shared_ptr<ModelFCN> FCN;
+    std::shared_ptr<ModelGradFCN> GradFCN; //Also gives the gradient, used when the model function could be compiled.
     std::vector<double> InitialVect;
     std::vector<double> StepVect;
     std::vector<std::string> Sets;
@@ -67,20 +136,21 @@ namespace NESTModel
     std::vector<double> LimitsHigh;
     std::vector<double> Parameters;
     std::vector<double> ParameterErrors;
+    std::vector<double> Covariance; //Covariance of the parameters, row by row, so it outlives the minimizer's state.
     std::shared_ptr<SettingsObject> Settings;
     std::shared_ptr<FunctionObject> FuncObject;
     std::shared_ptr<TF2> ModelFunction2D;
     std::shared_ptr<TF1> ModelFunction1D;
+    std::shared_ptr<ExpressionObject> Expression; //Compiled form of the model function, empty if TFormula has to be used.
+    std::vector< std::vector<double> > ExpressionWorkspaces; //Workspace for the evaluation of Expression, one per thread.
+    std::shared_ptr<ThreadPool> Pool; //Evaluates chunks of the data points concurrently, empty if FitThreads is 1.
+    std::shared_ptr<CompiledFunctionObject> Compiled; //Model function built into a shared library, empty unless CompileFormulas is set.
     std::string ModelType;
-    std::vector<double> DataX;
-    std::vector<double> DataXErrLow;
-    std::vector<double> DataXErrHigh;
-    std::vector<double> DataY;
-    std::vector<double> DataYErrLow;
-    std::vector<double> DataYErrHigh;
-    std::vector<double> DataZ;
-    std::vector<double> DataZErrLow;
-    std::vector<double> DataZErrHigh;
+    std::shared_ptr<const DataObject> Data; //Read-only, so it may be shared between models of the same ModelType.
+    std::vector<double> Residuals; //Workspace for the residuals of each data point.
+    std::vector<double> Solved; //Workspace for solving the covariance against the residuals.
+    std::vector<double> Weights; //Workspace for V^-1 times the residuals.
+    std::vector<double> Partials; //Gradient of each chunk of the data points, summed in a fixed order.
   };
 
   /*The following is left as an example for inheritance. You want to specify the following, as well
@@ -91,46 +161,39 @@ namespace NESTModel
     using BasicModel::BasicModel; //Tell the compiler that we WANT to inherit BaseModel's constructors.
     };*/
 
-  BasicModel* GlobalModel;
-
-  void Chi2(int& npar, double *x, double &result, double *par, int flag)
+  //Minuit-facing objective function. Each instance is bound to a single BasicModel, so several fits
+  //can be minimized at the same time (e.g. on separate threads) without any global state.
+  class ModelFCN : public ROOT::Math::IMultiGenFunction
   {
-    double WRSS(0);
-    double Difference(0);
-    double Error(0);
-    double xData[2];
-    for(unsigned int datum(0); datum < GlobalModel->GetDataX().size(); ++datum)
-    {
-      xData[0] = GlobalModel->GetDataX().at(datum);
-      xData[1] = GlobalModel->GetDataY().at(datum);
-      Difference = GlobalModel->GetDataZ().at(datum) - (*GlobalModel)(xData, par);
-
-      if(Difference < 0) Error += TMath::Power(GlobalModel->GetDataZErrHigh().at(datum), 2.0); //Add the higher error in the measurement if we estimated high.
-      else Error += TMath::Power(GlobalModel->GetDataZErrLow().at(datum), 2.0); //Add the lower error in the measurment if we estimated low.
-      Error += TMath::Power( (0.5*(GlobalModel->GetDataXErrLow().at(datum) + GlobalModel->GetDataXErrHigh().at(datum)))*(GlobalModel->DerivativeX(xData,par)), 2.0); //Add the error in the x independent variable.
-      Error += TMath::Power( (0.5*(GlobalModel->GetDataYErrLow().at(datum) + GlobalModel->GetDataYErrHigh().at(datum)))*(GlobalModel->DerivativeY(xData,par)), 2.0); //Add the error in the y independent variable.
-      WRSS += TMath::Power(Difference, 2.0) / Error;
-      Error = 0;
-    }
-    result = WRSS;
-  }
+  public:
+    ModelFCN(BasicModel& model);
+    ROOT::Math::IMultiGenFunction* Clone() const;
+    unsigned int NDim() const;
+    unsigned long GetNCalls() const;
+  private:
+    double DoEval(const double* par) const;
+    BasicModel* Model;
+    mutable std::atomic<unsigned long> NCalls; //Number of evaluations requested by the minimizer, which may be concurrent.
+  };
 
-  void Chi2Covariance(int& npar, double *x, double &result, double *par, int flag)
+  //Same objective function, but also providing the exact gradient, so that MIGRAD doesn't need 2*NPar
+  //evaluations of the chi-square to estimate it by finite differences.
+  class ModelGradFCN : public ROOT::Math::IMultiGradFunction
   {
-    double xData[2];
-    int NData(GlobalModel->GetNData());
-    int NPar(GlobalModel->GetNPar());
-    TMatrixT<double> Difference(NData, 1);
-    TMatrixT<double> TMP(NData, 1);
-    result = 0;
-    for(unsigned int i(0); i < NData; ++i)
-    {
-      xData[0] = GlobalModel->GetDataX().at(i);
-      xData[1] = GlobalModel->GetDataY().at(i);
-      Difference(i,0) = GlobalModel->GetDataZ().at(i) - (*GlobalModel)(xData, par);
-    }
-    TMP.Mult(GlobalModel->GetInvCovariance(), Difference);
-    for(unsigned int i(0); i < NData; ++i) result += Difference(i,0) * TMP(i,0);
-  }
+  public:
+    ModelGradFCN(BasicModel& model);
+    ROOT::Math::IMultiGradFunction* Clone() const;
+    unsigned int NDim() const;
+    void Gradient(const double* par, double* grad) const;
+    void FdF(const double* par, double& f, double* grad) const;
+    unsigned long GetNCalls() const;
+  private:
+    double DoEval(const double* par) const;
+    double DoDerivative(const double* par, unsigned int icoord) const;
+    BasicModel* Model;
+    mutable std::atomic<unsigned long> NCalls; //Number of evaluations (with or without the gradient) requested by the minimizer.
+    mutable std::vector<double> GradientPoint; //Parameters of the last gradient evaluated by DoDerivative.
+    mutable std::vector<double> GradientBuffer; //That gradient, so asking for each coordinate in turn computes it once.
+  };
 }
 #endif
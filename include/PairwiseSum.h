@@ -0,0 +1,18 @@
+#ifndef PAIRWISESUM_H
+#define PAIRWISESUM_H
+
+//Sum of Value(i) for Begin <= i < End, added in pairs of halves down to runs of 16 terms. The order of the
+//additions only depends on Begin and End, so a sum whose terms were computed on any number of threads is
+//bit-identical to the serial one, and the rounding error grows like log(N) rather than N.
+template<class Term> double PairwiseSum(unsigned int Begin, unsigned int End, const Term& Value)
+{
+  if(End - Begin <= 16)
+  {
+    double Sum(0);
+    for(unsigned int i(Begin); i < End; ++i) Sum += Value(i);
+    return Sum;
+  }
+  unsigned int Middle(Begin + (End - Begin)/2);
+  return PairwiseSum(Begin, Middle, Value) + PairwiseSum(Middle, End, Value);
+}
+#endif
@@ -10,6 +10,7 @@ class SettingsObject
  public:
   SettingsObject(std::string SettingsFile = "");
   std::string Query(std::string Key);
+  void Set(std::string Key, std::string Value); //Overrides a setting of the file, e.g. in the tests.
   friend std::ostream& operator<<(std::ostream& os, const SettingsObject& Obj);
  private:
   std::map<std::string, std::string> SettingsMap;
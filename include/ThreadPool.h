@@ -0,0 +1,41 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+//C++ includes.
+#include <vector> //STL vector.
+#include <deque> //STL deque.
+#include <thread> //For using std::thread.
+#include <mutex> //For using std::mutex.
+#include <condition_variable> //For waking up idle workers.
+#include <functional> //For using std::function.
+#include <future> //For returning results of submitted tasks.
+#include <memory> //For using shared_ptr.
+
+//A fixed-size pool of worker threads. Tasks are executed in the order they are submitted.
+class ThreadPool
+{
+ public:
+  ThreadPool(unsigned int NThreads = 0);
+  ~ThreadPool();
+  template<class Task> std::future<decltype(std::declval<Task>()())> Submit(Task task);
+  unsigned int GetNThreads();
+ private:
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+  void Enqueue(std::function<void()> Job);
+  void WorkerLoop();
+  std::vector<std::thread> Workers;
+  std::deque< std::function<void()> > Jobs;
+  std::mutex JobsMutex;
+  std::condition_variable JobsCondition;
+  bool Stopping;
+};
+
+template<class Task> std::future<decltype(std::declval<Task>()())> ThreadPool::Submit(Task task)
+{
+  typedef decltype(std::declval<Task>()()) ResultType;
+  std::shared_ptr< std::packaged_task<ResultType()> > Packaged(new std::packaged_task<ResultType()>(task)); //Shared so that the job can be copied into a std::function.
+  std::future<ResultType> Result(Packaged->get_future());
+  Enqueue([Packaged]() { (*Packaged)(); });
+  return Result;
+}
+#endif
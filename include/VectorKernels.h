@@ -0,0 +1,25 @@
+#ifndef VECTORKERNELS_H
+#define VECTORKERNELS_H
+
+//Element-wise kernels over arrays of doubles, used to evaluate a formula for a block of data points at once.
+//V operands are arrays of n values and U operands are a single value shared by every element. Each kernel
+//is built twice, once for the generic instruction set and once for AVX2; Get() picks the one the CPU supports.
+//Exp, Log, and Pow use polynomial approximations that vectorize and agree with <cmath> to a few ulp
+//(Pow to ~1e-16*|b*log(a)| relative); out of range and non-positive arguments fall back to <cmath>.
+struct VectorKernels
+{
+  typedef void (*BinaryVV)(const double* a, const double* b, double* out, unsigned int n);
+  typedef void (*BinaryVU)(const double* a, double b, double* out, unsigned int n);
+  typedef void (*BinaryUV)(double a, const double* b, double* out, unsigned int n);
+  typedef void (*Unary)(const double* a, double* out, unsigned int n);
+
+  const char* Name;
+  BinaryVV AddVV, SubVV, MulVV, DivVV, PowVV;
+  BinaryVU AddVU, SubVU, MulVU, DivVU, PowVU;
+  BinaryUV SubUV, DivUV, PowUV;
+  Unary Neg, Square, Sqrt, Abs, Exp, Log;
+
+  static const VectorKernels& Get();
+  static const VectorKernels& GetGeneric();
+};
+#endif
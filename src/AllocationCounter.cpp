@@ -0,0 +1,68 @@
+//C++ includes.
+#include <new> //Declarations of the replaced operators.
+#include <atomic> //Counts the allocations of every thread.
+#include <cstdlib> //For std::malloc and std::free.
+
+//Custom includes.
+#include "AllocationCounter.h" //Header file for this implementation.
+
+namespace
+{
+  std::atomic<unsigned long> NAllocations(0);
+
+  void* Allocate(std::size_t Size)
+  {
+    ++NAllocations;
+    return std::malloc(Size ? Size : 1);
+  }
+
+#if __cpp_aligned_new
+  void* Allocate(std::size_t Size, std::align_val_t Alignment)
+  {
+    ++NAllocations;
+    void* Memory(nullptr);
+    std::size_t Align(static_cast<std::size_t>(Alignment));
+    if(posix_memalign(&Memory, Align < sizeof(void*) ? sizeof(void*) : Align, Size ? Size : 1) != 0) return nullptr;
+    return Memory;
+  }
+#endif
+}
+
+unsigned long GetNAllocations()
+{
+  return NAllocations.load();
+}
+
+void* operator new(std::size_t Size)
+{
+  void* Memory(Allocate(Size));
+  if(!Memory) throw std::bad_alloc();
+  return Memory;
+}
+void* operator new[](std::size_t Size) { return operator new(Size); }
+void* operator new(std::size_t Size, const std::nothrow_t&) noexcept { return Allocate(Size); }
+void* operator new[](std::size_t Size, const std::nothrow_t&) noexcept { return Allocate(Size); }
+void operator delete(void* Memory) noexcept { std::free(Memory); }
+void operator delete[](void* Memory) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::size_t) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, std::size_t) noexcept { std::free(Memory); }
+void operator delete(void* Memory, const std::nothrow_t&) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, const std::nothrow_t&) noexcept { std::free(Memory); }
+
+#if __cpp_aligned_new
+void* operator new(std::size_t Size, std::align_val_t Alignment)
+{
+  void* Memory(Allocate(Size, Alignment));
+  if(!Memory) throw std::bad_alloc();
+  return Memory;
+}
+void* operator new[](std::size_t Size, std::align_val_t Alignment) { return operator new(Size, Alignment); }
+void* operator new(std::size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept { return Allocate(Size, Alignment); }
+void* operator new[](std::size_t Size, std::align_val_t Alignment, const std::nothrow_t&) noexcept { return Allocate(Size, Alignment); }
+void operator delete(void* Memory, std::align_val_t) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, std::align_val_t) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::size_t, std::align_val_t) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, std::size_t, std::align_val_t) noexcept { std::free(Memory); }
+void operator delete(void* Memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(Memory); }
+void operator delete[](void* Memory, std::align_val_t, const std::nothrow_t&) noexcept { std::free(Memory); }
+#endif
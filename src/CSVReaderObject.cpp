@@ -0,0 +1,161 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads the file in chunks.
+#include <iostream> //Basic input and output.
+#include <charconv> //For std::from_chars.
+#include <cstring> //For std::memchr and std::memmove.
+#include <algorithm> //For std::count.
+#include <thread> //For std::thread::hardware_concurrency.
+#include <future> //Results of the parsing tasks.
+#include <memory> //For using shared_ptr.
+
+//Custom includes.
+#include "CSVReaderObject.h" //Header file for this implementation.
+#include "ThreadPool.h" //Parses the chunks of large files concurrently.
+
+CSVReaderObject::CSVReaderObject(std::string FileName, unsigned int NThreads)
+{
+  this->FileName = FileName;
+  Input.open(FileName, std::ios::binary);
+  if(NThreads == 0) NThreads = std::thread::hardware_concurrency(); //Zero means one thread per core.
+  this->NThreads = NThreads == 0 ? 1 : NThreads;
+  NErrors = 0;
+}
+
+bool CSVReaderObject::IsOpen() const
+{
+  return Input.is_open();
+}
+
+unsigned int CSVReaderObject::GetNErrors() const
+{
+  return NErrors;
+}
+
+unsigned int CSVReaderObject::Read(std::vector<double>& Values, unsigned int NColumns)
+{
+  Values.clear();
+  if(!Input.is_open()) return 0;
+  Input.seekg(0, std::ios::end);
+  std::size_t FileSize(Input.tellg());
+  Input.seekg(0, std::ios::beg);
+  std::shared_ptr<ThreadPool> Pool;
+  if(NThreads > 1 && FileSize > 4*ChunkSize) Pool.reset(new ThreadPool(NThreads)); //Not worth starting threads for small files.
+  std::size_t BlockSize(Pool ? NThreads*ChunkSize : ChunkSize);
+
+  std::vector<char> Buffer;
+  std::size_t Carry(0); //Bytes of an incomplete line, left from the previous block.
+  unsigned long Line(1); //Line number at the start of the buffer.
+  bool Last(false);
+  while(!Last)
+  {
+    Buffer.resize(Carry + BlockSize);
+    Input.read(Buffer.data() + Carry, BlockSize);
+    std::size_t Size(Carry + Input.gcount());
+    Last = !Input;
+    const char* Begin(Buffer.data());
+    const char* End(Begin + Size); //End of the last complete line.
+    if(!Last)
+    {
+      while(End > Begin && End[-1] != '\n') --End;
+      if(End == Begin) //A line longer than the block: read on.
+      {
+	Carry = Size;
+	continue;
+      }
+    }
+
+    //Split at line ends into one piece per thread. The number of columns must be known by then, so that every
+    //piece checks the rows against the same number: until then, a single piece is parsed.
+    std::vector<const char*> Bounds(1, Begin);
+    unsigned int NPieces(Pool && NColumns != 0 ? Pool->GetNThreads() : 1);
+    for(unsigned int p(1); p < NPieces; ++p)
+    {
+      const char* Split(Begin + (End-Begin)*p/NPieces);
+      if(Split < Bounds.back()) Split = Bounds.back();
+      const char* NewLine(static_cast<const char*>(std::memchr(Split, '\n', End-Split)));
+      Bounds.push_back(NewLine ? NewLine+1 : End);
+    }
+    Bounds.push_back(End);
+    std::vector<Piece> Pieces(NPieces);
+    if(NPieces == 1) Parse(Bounds.at(0), Bounds.at(1), NColumns, Pieces.at(0));
+    else
+    {
+      std::vector< std::future<void> > Done;
+      for(unsigned int p(0); p < NPieces; ++p)
+      {
+	const char* PieceBegin(Bounds.at(p));
+	const char* PieceEnd(Bounds.at(p+1));
+	Piece* Out(&Pieces.at(p));
+	unsigned int Columns(NColumns);
+	Done.push_back(Pool->Submit([PieceBegin, PieceEnd, Columns, Out]() { unsigned int c(Columns); Parse(PieceBegin, PieceEnd, c, *Out); }));
+      }
+      for(unsigned int p(0); p < NPieces; ++p) Done.at(p).get();
+    }
+    for(unsigned int p(0); p < NPieces; ++p) //In file order.
+    {
+      Values.insert(Values.end(), Pieces.at(p).Values.begin(), Pieces.at(p).Values.end());
+      for(unsigned int e(0); e < Pieces.at(p).Errors.size(); ++e)
+      {
+	std::cerr << "CSVReaderObject::Read(): " << FileName << ", line " << Line + Pieces.at(p).Errors.at(e).first << ": " << Pieces.at(p).Errors.at(e).second << std::endl;
+	++NErrors;
+      }
+      Line += Pieces.at(p).NLines;
+    }
+    Carry = Buffer.data() + Size - End;
+    std::memmove(Buffer.data(), End, Carry);
+  }
+  return NColumns;
+}
+
+void CSVReaderObject::Parse(const char* Begin, const char* End, unsigned int& NColumns, Piece& Out)
+{
+  Out.NLines = std::count(Begin, End, '\n');
+  std::vector<double> Row;
+  unsigned long Line(0);
+  const char* LineBegin(Begin);
+  while(LineBegin < End)
+  {
+    const char* LineEnd(static_cast<const char*>(std::memchr(LineBegin, '\n', End-LineBegin)));
+    if(!LineEnd) LineEnd = End;
+    const char* Next(LineEnd + 1);
+    if(LineEnd > LineBegin && LineEnd[-1] == '\r') --LineEnd; //Files written on Windows.
+    if(LineBegin < LineEnd && *LineBegin != '#') //Ignore lines starting with a '#' (comment).
+    {
+      Row.clear();
+      bool Failed(false);
+      const char* Field(LineBegin);
+      while(Field <= LineEnd && !Failed) //Fields delimited by a ','.
+      {
+	const char* FieldEnd(static_cast<const char*>(std::memchr(Field, ',', LineEnd-Field)));
+	if(!FieldEnd) FieldEnd = LineEnd;
+	const char* First(Field);
+	const char* Stop(FieldEnd);
+	while(First < Stop && (*First == ' ' || *First == '\t')) ++First;
+	while(Stop > First && (Stop[-1] == ' ' || Stop[-1] == '\t')) --Stop;
+	if(First < Stop) //Empty fields are skipped.
+	{
+	  if(*First == '+') ++First; //Accepted by stod, but not by from_chars.
+	  double Value(0);
+	  std::from_chars_result Result(std::from_chars(First, Stop, Value));
+	  if(Result.ec != std::errc() || Result.ptr != Stop)
+	  {
+	    Out.Errors.push_back(std::make_pair(Line, "Could not read \"" + std::string(Field, FieldEnd) + "\" as a number."));
+	    Failed = true;
+	  }
+	  else Row.push_back(Value);
+	}
+	Field = FieldEnd + 1;
+      }
+      if(!Failed && !Row.empty())
+      {
+	if(NColumns == 0) NColumns = Row.size();
+	if(Row.size() == NColumns) Out.Values.insert(Out.Values.end(), Row.begin(), Row.end());
+	else Out.Errors.push_back(std::make_pair(Line, "Found " + std::to_string(Row.size()) + " values instead of " + std::to_string(NColumns) + ". Check for a missing entry in a column."));
+      }
+    }
+    LineBegin = Next;
+    ++Line;
+  }
+}
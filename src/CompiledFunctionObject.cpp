@@ -0,0 +1,174 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <fstream> //Writes the generated source.
+#include <sstream> //Useful for number -> string conversion.
+#include <iostream> //Basic input and output.
+#include <cstdlib> //For std::system.
+#include <cstdio> //For std::rename and std::remove.
+#include <cctype> //Character classes for the tokenizer.
+#include <mutex> //Serializes builds within the process.
+#include <algorithm> //For std::max.
+
+//POSIX includes.
+#include <dlfcn.h> //Loads the compiled libraries.
+#include <sys/stat.h> //Creates the cache directory.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "CompiledFunctionObject.h" //Header file for this implementation.
+#include "HashObject.h" //Names the cached libraries.
+
+namespace
+{
+  std::mutex BuildMutex; //Models of a sweep are constructed concurrently, and may share recipe formulas.
+}
+
+CompiledFunctionObject::CompiledFunctionObject(std::string Formula, std::string CacheDirectory, std::string Compiler, bool& Success)
+{
+  NPar = 0;
+  Function = nullptr;
+  Batch = nullptr;
+  std::string Expression(Translate(Formula, NPar, Success));
+  if(!Success) return;
+
+  std::string Source("//Generated by MinuitFit from: " + Formula + "\n"
+		     "#include <cmath>\n"
+		     "extern \"C\" double MinuitFitFormula(double* x, double* p)\n"
+		     "{\n"
+		     "  return " + Expression + ";\n"
+		     "}\n"
+		     "extern \"C\" void MinuitFitFormulaBatch(const double* X, const double* Y, const double* p, double* Out, unsigned int N)\n"
+		     "{\n"
+		     "  double* par(const_cast<double*>(p));\n"
+		     "  for(unsigned int i(0); i < N; ++i)\n"
+		     "  {\n"
+		     "    double x[2] = {X[i], Y[i]};\n"
+		     "    Out[i] = MinuitFitFormula(x, par);\n"
+		     "  }\n"
+		     "}\n");
+  std::string Command(Compiler + " -O3 -fPIC -shared -fno-math-errno");
+  HashObject Hash;
+  Hash.Add(Command);
+  Hash.Add(Source);
+  Library = CacheDirectory + "/Formula_" + Hash.GetHex() + ".so";
+
+  std::lock_guard<std::mutex> Lock(BuildMutex);
+  Success = Load(); //Built by an earlier run.
+  if(!Success)
+  {
+    mkdir(CacheDirectory.c_str(), 0755); //Fails harmlessly if it already exists.
+    Success = Build(Source, Command) && Load();
+    if(!Success) std::cerr << "CompiledFunctionObject::CompiledFunctionObject(): Could not build " << Library << "." << std::endl;
+  }
+}
+
+std::string CompiledFunctionObject::Translate(std::string Formula, unsigned int& NPar, bool& Success)
+{
+  //Copies the formula token by token: [n] -> p[n], x -> x[0], y -> x[1], and the TMath functions to <cmath>.
+  //'^' means a power in TFormula but not in C++, so such formulas (and unknown names) are not translated.
+  std::string Expression;
+  NPar = 0;
+  Success = true;
+  std::size_t i(0);
+  while(i < Formula.size() && Success)
+  {
+    char Character(Formula[i]);
+    if(std::isdigit(static_cast<unsigned char>(Character)) || Character == '.') //Numbers, including exponents like "2e-3".
+    {
+      std::size_t End(i);
+      while(End < Formula.size() && (std::isdigit(static_cast<unsigned char>(Formula[End])) || Formula[End] == '.')) ++End;
+      if(End < Formula.size() && (Formula[End] == 'e' || Formula[End] == 'E'))
+      {
+	++End;
+	if(End < Formula.size() && (Formula[End] == '+' || Formula[End] == '-')) ++End;
+	while(End < Formula.size() && std::isdigit(static_cast<unsigned char>(Formula[End]))) ++End;
+      }
+      Expression += Formula.substr(i, End-i);
+      i = End;
+    }
+    else if(std::isalpha(static_cast<unsigned char>(Character)) || Character == '_')
+    {
+      std::size_t End(i);
+      while(End < Formula.size() && (std::isalnum(static_cast<unsigned char>(Formula[End])) || Formula[End] == '_' || Formula[End] == ':')) ++End;
+      std::string Name(Formula.substr(i, End-i));
+      if(Name == "x") Expression += "x[0]";
+      else if(Name == "y") Expression += "x[1]";
+      else if(Name == "TMath::Power" || Name == "pow") Expression += "std::pow";
+      else if(Name == "TMath::Exp" || Name == "exp") Expression += "std::exp";
+      else if(Name == "TMath::Log" || Name == "log") Expression += "std::log";
+      else if(Name == "TMath::Sqrt" || Name == "sqrt") Expression += "std::sqrt";
+      else if(Name == "TMath::Abs" || Name == "abs" || Name == "fabs") Expression += "std::fabs";
+      else Success = false;
+      i = End;
+    }
+    else if(Character == '[')
+    {
+      std::size_t Close(Formula.find(']', i));
+      std::string Index(Close == std::string::npos ? "" : Formula.substr(i+1, Close-i-1));
+      if(Index.empty() || Index.find_first_not_of("0123456789") != std::string::npos) Success = false;
+      else
+      {
+	NPar = std::max(NPar, static_cast<unsigned int>(std::stoul(Index))+1);
+	Expression += "p[" + Index + "]";
+	i = Close+1;
+      }
+    }
+    else if(Character == '^' || Character == ';' || Character == '{' || Character == '}' || Character == '"' || Character == '#') Success = false;
+    else
+    {
+      Expression += Character;
+      ++i;
+    }
+  }
+  return Expression;
+}
+
+bool CompiledFunctionObject::Build(const std::string& Source, const std::string& Command) const
+{
+  //Built under a temporary name and renamed, so that other processes never load a partially written library.
+  std::string Temporary(Library + "." + std::to_string(getpid()));
+  std::ofstream Output(Temporary + ".cpp");
+  Output << Source;
+  Output.close();
+  if(!Output) return false;
+  bool Built(std::system((Command + " -o '" + Temporary + "' '" + Temporary + ".cpp'").c_str()) == 0);
+  std::remove((Temporary + ".cpp").c_str());
+  if(Built) Built = std::rename(Temporary.c_str(), Library.c_str()) == 0;
+  else std::remove(Temporary.c_str());
+  return Built;
+}
+
+bool CompiledFunctionObject::Load()
+{
+  //The library is never closed: the functions may still be referenced by a TF1/TF2 or the minimizer.
+  void* Handle(dlopen(Library.c_str(), RTLD_NOW | RTLD_LOCAL));
+  if(!Handle) return false;
+  Function = reinterpret_cast<ScalarFunction>(dlsym(Handle, "MinuitFitFormula"));
+  Batch = reinterpret_cast<BatchFunction>(dlsym(Handle, "MinuitFitFormulaBatch"));
+  return Function && Batch;
+}
+
+double CompiledFunctionObject::operator()(double* x, double* p) const
+{
+  return Function(x, p);
+}
+
+void CompiledFunctionObject::Evaluate(const double* X, const double* Y, const double* p, double* Out, unsigned int N) const
+{
+  Batch(X, Y, p, Out, N);
+}
+
+CompiledFunctionObject::ScalarFunction CompiledFunctionObject::GetFunction() const
+{
+  return Function;
+}
+
+unsigned int CompiledFunctionObject::GetNPar() const
+{
+  return NPar;
+}
+
+std::string CompiledFunctionObject::GetLibrary() const
+{
+  return Library;
+}
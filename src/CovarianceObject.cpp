@@ -0,0 +1,185 @@
+//C++ includes.
+#include <vector> //STL vector.
+#include <iostream> //Basic input and output.
+#include <future> //Results of the blocks solved on the thread pool.
+#include <algorithm> //For std::max and std::min.
+#include <functional> //For std::function.
+#include <cmath> //For std::sqrt and std::isfinite.
+
+//Custom includes.
+#include "CovarianceObject.h" //Header file for this implementation.
+#include "ThreadPool.h" //Solves the blocks concurrently.
+#include "PairwiseSum.h" //Sums in a fixed order.
+
+//Condition numbers above this leave fewer than ~4 significant digits in the chi-square, so they are reported.
+static const double MaxCondition(1e12);
+
+CovarianceObject::CovarianceObject()
+{
+  N = 0;
+  WorkspaceSize = 0;
+}
+
+CovarianceObject::CovarianceObject(const std::vector<CovarianceBlock>& Blocks, bool& Success)
+{
+  //The workspace holds one value per data point, then the chi-square of each block, then Rank values per block.
+  N = 0;
+  unsigned int Scratch(0);
+  for(unsigned int b(0); b < Blocks.size(); ++b)
+  {
+    Offsets.push_back(N);
+    Sizes.push_back(Blocks.at(b).Diagonal.size());
+    Ranks.push_back(Blocks.at(b).Rank);
+    ScratchOffsets.push_back(Scratch);
+    N += Sizes.back();
+    Scratch += Ranks.back();
+  }
+  for(unsigned int b(0); b < Blocks.size(); ++b) ScratchOffsets.at(b) += N + Blocks.size();
+  WorkspaceSize = N + Blocks.size() + Scratch;
+  Conditions.assign(Blocks.size(), -1);
+  InverseDiagonals.resize(Blocks.size());
+  Factors.resize(Blocks.size());
+  Capacitances.resize(Blocks.size());
+
+  Success = true;
+  for(unsigned int b(0); b < Blocks.size(); ++b) Success = Factorize(Blocks.at(b), b) && Success;
+}
+
+bool CovarianceObject::Factorize(const CovarianceBlock& Block, unsigned int Index)
+{
+  unsigned int n(Sizes.at(Index)), k(Ranks.at(Index));
+  if(Block.Factor.size() != static_cast<std::size_t>(n)*k)
+  {
+    std::cerr << "CovarianceObject::CovarianceObject(): The low rank factor of data set " << Index << " has " << Block.Factor.size() << " entries instead of " << n*k << "." << std::endl;
+    return false;
+  }
+  double Smallest(0), Largest(0), Trace(0);
+  std::vector<double>& Inverse(InverseDiagonals.at(Index));
+  Inverse.resize(n);
+  for(unsigned int i(0); i < n; ++i)
+  {
+    double d(Block.Diagonal.at(i));
+    if(!(d > 0) || !std::isfinite(d))
+    {
+      std::cerr << "CovarianceObject::CovarianceObject(): The covariance of data set " << Index << " is not positive definite. Check it for zero or negative uncertainties." << std::endl;
+      return false;
+    }
+    Inverse[i] = 1.0/d;
+    Smallest = i == 0 ? d : std::min(Smallest, d);
+    Largest = std::max(Largest, d);
+  }
+  for(std::size_t i(0); i < Block.Factor.size(); ++i) Trace += Block.Factor[i]*Block.Factor[i];
+  Factors.at(Index) = Block.Factor;
+  //The eigenvalues of V lie between min(D) and max(D) + trace(U*U^T).
+  Conditions.at(Index) = n == 0 ? 1 : (Largest + Trace)/Smallest;
+  if(Conditions.at(Index) > MaxCondition) std::cerr << "CovarianceObject::CovarianceObject(): The covariance of data set " << Index << " may be poorly conditioned (condition number up to " << Conditions.at(Index) << "). Fit results may be unreliable." << std::endl;
+
+  //K = 1 + U^T*D^-1*U is positive definite whatever U is, so its Cholesky factor always exists.
+  std::vector<double>& L(Capacitances.at(Index));
+  L.assign(k*(k+1)/2, 0);
+  for(unsigned int a(0); a < k; ++a) for(unsigned int c(0); c <= a; ++c)
+  {
+    double Sum(a == c ? 1 : 0);
+    for(unsigned int i(0); i < n; ++i) Sum += Block.Factor[i*k+a]*Inverse[i]*Block.Factor[i*k+c];
+    L[a*(a+1)/2 + c] = Sum;
+  }
+  for(unsigned int a(0); a < k; ++a)
+  {
+    double* Row(&L[a*(a+1)/2]);
+    for(unsigned int c(0); c <= a; ++c)
+    {
+      const double* Other(&L[c*(c+1)/2]);
+      double Sum(Row[c]);
+      for(unsigned int j(0); j < c; ++j) Sum -= Row[j]*Other[j];
+      Row[c] = a == c ? std::sqrt(Sum) : Sum/Other[c];
+    }
+  }
+  return true;
+}
+
+double CovarianceObject::Chi2(const double* Residuals) const
+{
+  std::vector<double> Workspace(WorkspaceSize);
+  return Chi2(Residuals, Workspace.data());
+}
+
+double CovarianceObject::Chi2(const double* Residuals, double* Workspace, ThreadPool* Pool) const
+{
+  ForEachBlock([this, Residuals, Workspace](unsigned int b) { Solve(b, Residuals, Workspace, nullptr); }, Pool);
+  return PairwiseSum(N, N + Sizes.size(), [Workspace](unsigned int b) { return Workspace[b]; });
+}
+
+double CovarianceObject::Chi2(const double* Residuals, double* Workspace, double* Weights, ThreadPool* Pool) const
+{
+  //d(chi-square)/dp = -2*v^T*df/dp with v = V^-1*r.
+  ForEachBlock([this, Residuals, Workspace, Weights](unsigned int b) { Solve(b, Residuals, Workspace, Weights); }, Pool);
+  return PairwiseSum(N, N + Sizes.size(), [Workspace](unsigned int b) { return Workspace[b]; });
+}
+
+void CovarianceObject::ForEachBlock(const std::function<void(unsigned int)>& Body, ThreadPool* Pool) const
+{
+  //The blocks are independent, so they can be solved concurrently.
+  if(Pool && Sizes.size() > 1)
+  {
+    std::vector< std::future<void> > Done;
+    for(unsigned int b(0); b < Sizes.size(); ++b) Done.push_back(Pool->Submit([&Body, b]() { Body(b); }));
+    for(unsigned int b(0); b < Done.size(); ++b) Done.at(b).get();
+  }
+  else for(unsigned int b(0); b < Sizes.size(); ++b) Body(b);
+}
+
+void CovarianceObject::Solve(unsigned int Block, const double* Residuals, double* Workspace, double* Weights) const
+{
+  //With s = D^-1*r and z = U^T*s, the chi-square is r^T*s - z^T*K^-1*z = r^T*s - |y|^2, where L*y = z.
+  //Then t = L^-T*y = K^-1*z, and V^-1*r = s - D^-1*U*t.
+  unsigned int n(Sizes[Block]), k(Ranks[Block]);
+  const double* r(Residuals + Offsets[Block]);
+  const double* Inverse(InverseDiagonals[Block].data());
+  const double* U(Factors[Block].data());
+  const double* L(Capacitances[Block].data());
+  double* s(Workspace + Offsets[Block]);
+  double* y(Workspace + ScratchOffsets[Block]);
+  for(unsigned int i(0); i < n; ++i) s[i] = r[i]*Inverse[i];
+  double Chi2(PairwiseSum(0, n, [r, s](unsigned int i) { return r[i]*s[i]; }));
+  if(k > 0)
+  {
+    for(unsigned int a(0); a < k; ++a) y[a] = 0;
+    for(unsigned int i(0); i < n; ++i) for(unsigned int a(0); a < k; ++a) y[a] += U[i*k+a]*s[i];
+    for(unsigned int a(0); a < k; ++a)
+    {
+      const double* Row(&L[a*(a+1)/2]);
+      for(unsigned int c(0); c < a; ++c) y[a] -= Row[c]*y[c];
+      y[a] /= Row[a];
+      Chi2 -= y[a]*y[a];
+    }
+  }
+  Workspace[N + Block] = Chi2;
+  if(!Weights) return;
+  double* v(Weights + Offsets[Block]);
+  for(unsigned int a(k); a-- > 0;) //Runs over the rows of L, which are contiguous in memory, rather than over its columns.
+  {
+    const double* Row(&L[a*(a+1)/2]);
+    y[a] /= Row[a];
+    for(unsigned int c(0); c < a; ++c) y[c] -= Row[c]*y[a];
+  }
+  for(unsigned int i(0); i < n; ++i)
+  {
+    double Correction(0);
+    for(unsigned int a(0); a < k; ++a) Correction += U[i*k+a]*y[a];
+    v[i] = s[i] - Inverse[i]*Correction;
+  }
+}
+
+unsigned int CovarianceObject::GetN() const { return N; }
+
+unsigned int CovarianceObject::GetWorkspaceSize() const { return WorkspaceSize; }
+
+unsigned int CovarianceObject::GetNBlocks() const { return Sizes.size(); }
+
+unsigned int CovarianceObject::GetBlockOffset(unsigned int Block) const { return Offsets.at(Block); }
+
+unsigned int CovarianceObject::GetBlockSize(unsigned int Block) const { return Sizes.at(Block); }
+
+unsigned int CovarianceObject::GetRank(unsigned int Block) const { return Ranks.at(Block); }
+
+double CovarianceObject::GetCondition(unsigned int Block) const { return Conditions.at(Block); }
@@ -0,0 +1,142 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Writes the cache.
+#include <cstring> //For std::memcpy and std::memcmp.
+#include <cstdio> //For std::rename and std::remove.
+
+//POSIX includes.
+#include <sys/mman.h> //Maps the cache into memory.
+#include <sys/stat.h> //Modification time and size of the files.
+#include <fcntl.h> //For open.
+#include <unistd.h> //For close.
+#include <stdlib.h> //For mkstemp.
+
+//Custom includes.
+#include "DataCacheObject.h" //Header file for this implementation.
+#include "HashObject.h" //Detects changed data sets.
+
+namespace
+{
+  const char Magic[8] = "MFDATA1";
+  const uint32_t Version = 3; //To be increased whenever the way the data sets are parsed changes.
+
+  struct Header
+  {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t NColumns;
+    uint64_t NRows;
+    int64_t MTime;
+    uint64_t Size;
+    uint64_t Hash;
+    double Defaults[4];
+  };
+}
+
+DataCacheObject::DataCacheObject(std::string CSVName, const std::vector<double>& Defaults)
+{
+  this->CSVName = CSVName;
+  CacheName = CSVName + ".cache";
+  this->Defaults = Defaults;
+  this->Defaults.resize(4, 0);
+  Mapping = nullptr;
+  MappingSize = 0;
+  NRows = 0;
+}
+
+DataCacheObject::~DataCacheObject()
+{
+  if(Mapping) munmap(Mapping, MappingSize);
+}
+
+bool DataCacheObject::Stat(int64_t& MTime, uint64_t& Size) const
+{
+  struct stat Status;
+  if(stat(CSVName.c_str(), &Status) != 0) return false;
+  MTime = Status.st_mtime;
+  Size = Status.st_size;
+  return true;
+}
+
+uint64_t DataCacheObject::HashCSV() const
+{
+  HashObject Hash;
+  Hash.AddFile(CSVName);
+  return Hash.Get();
+}
+
+bool DataCacheObject::Load()
+{
+  int64_t MTime;
+  uint64_t Size;
+  if(!Stat(MTime, Size)) return false;
+  int File(open(CacheName.c_str(), O_RDONLY));
+  if(File < 0) return false;
+  struct stat Status;
+  if(fstat(File, &Status) != 0 || static_cast<std::size_t>(Status.st_size) < sizeof(Header))
+  {
+    close(File);
+    return false;
+  }
+  MappingSize = Status.st_size;
+  Mapping = mmap(nullptr, MappingSize, PROT_READ, MAP_PRIVATE, File, 0);
+  close(File); //The mapping stays valid.
+  if(Mapping == MAP_FAILED)
+  {
+    Mapping = nullptr;
+    return false;
+  }
+  const Header* Head(static_cast<const Header*>(Mapping));
+  bool Valid(std::memcmp(Head->Magic, Magic, sizeof(Magic)) == 0 && Head->Version == Version && Head->NColumns == NColumns);
+  Valid = Valid && MappingSize == sizeof(Header) + NColumns*Head->NRows*sizeof(double);
+  for(unsigned int d(0); d < 4 && Valid; ++d) Valid = Head->Defaults[d] == Defaults.at(d);
+  Valid = Valid && Head->Size == Size && Head->Hash == HashCSV(); //The mtime is only informative.
+  if(!Valid)
+  {
+    munmap(Mapping, MappingSize);
+    Mapping = nullptr;
+    return false;
+  }
+  NRows = Head->NRows;
+  return true;
+}
+
+bool DataCacheObject::Save(const std::vector< std::vector<double> >& Columns)
+{
+  //Written under a temporary name and renamed, so that concurrent runs never map a partial cache. The name is
+  //unique to this call, since models loading the same set on several threads save its cache concurrently.
+  //Failing to write it (e.g. in a read-only directory) only means that the next run parses the CSV again.
+  Header Head;
+  std::memset(&Head, 0, sizeof(Head));
+  std::memcpy(Head.Magic, Magic, sizeof(Magic));
+  Head.Version = Version;
+  Head.NColumns = NColumns;
+  Head.NRows = Columns.empty() ? 0 : Columns.at(0).size();
+  if(Columns.size() != NColumns || !Stat(Head.MTime, Head.Size)) return false;
+  for(unsigned int c(0); c < NColumns; ++c) if(Columns.at(c).size() != Head.NRows) return false;
+  Head.Hash = HashCSV();
+  for(unsigned int d(0); d < 4; ++d) Head.Defaults[d] = Defaults.at(d);
+  std::string Temporary(CacheName + ".XXXXXX");
+  int Descriptor(mkstemp(&Temporary[0]));
+  if(Descriptor < 0) return false;
+  fchmod(Descriptor, 0644); //As a cache written by std::ofstream, rather than mkstemp's 0600.
+  close(Descriptor);
+  std::ofstream Output(Temporary, std::ios::binary);
+  Output.write(reinterpret_cast<const char*>(&Head), sizeof(Head));
+  for(unsigned int c(0); c < NColumns; ++c) Output.write(reinterpret_cast<const char*>(Columns.at(c).data()), Head.NRows*sizeof(double));
+  Output.close();
+  if(Output && std::rename(Temporary.c_str(), CacheName.c_str()) == 0) return true;
+  std::remove(Temporary.c_str());
+  return false;
+}
+
+uint64_t DataCacheObject::GetNRows() const
+{
+  return NRows;
+}
+
+const double* DataCacheObject::GetColumn(unsigned int Column) const
+{
+  return reinterpret_cast<const double*>(static_cast<const char*>(Mapping) + sizeof(Header)) + Column*NRows;
+}
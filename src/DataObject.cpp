@@ -5,12 +5,23 @@
 #include <iostream> //Basic input and output.
 #include <cmath> //Basic math functions.
 #include <memory> //For using shared_ptr.
+#include <map> //STL map.
+#include <atomic> //Counts the recipe functions, to name them.
+#include <algorithm> //For std::min and std::max.
 
 //Custom includes.
 #include "DataObject.h" //Header file for this implementation.
 #include "FunctionObject.h" //Modularizes the input of model functions from a .txt file.
+#include "CompiledFunctionObject.h" //Recipe model built into a shared library.
+#include "DataCacheObject.h" //Binary copy of the parsed data sets.
+#include "CSVReaderObject.h" //Parses the data sets and model logs.
 
-DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> Recipes, double DefaultYieldUncertainty, double DefaultEnergyUncertainty, double DefaultFieldUncertainty, double LowField)
+namespace
+{
+  std::atomic<unsigned int> NRecipeModels(0);
+}
+
+DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> Recipes, double DefaultYieldUncertainty, double DefaultEnergyUncertainty, double DefaultFieldUncertainty, double LowField, std::string FunctionDefinitions, std::string FormulaCache, std::string FormulaCompiler, std::map<std::string, RecipeResult> RecipeResults, bool UseDataCache)
 {
   std::ifstream Input;
   std::string FileName;
@@ -21,8 +32,7 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
   bool success(false), recipe(false);
   TMatrixT<double> ModelCovariance(1,1);
   std::vector<double> ModelPieces, TMPDataX, TMPDataXErrLow, TMPDataXErrHigh, TMPDataY, TMPDataYErrLow, TMPDataYErrHigh, TMPDataZ, TMPDataZErrLow, TMPDataZErrHigh;
-  std::vector< std::vector<double> > DataVector;
-  std::vector<TMatrixT<double> > SetCovariances;
+  std::vector< std::vector<double> > DataVector, Columns;
   
   for(unsigned int set(0); set < Sets.size(); ++set)
   {
@@ -30,7 +40,41 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
     Input.open(FileName);  
     if(Input.is_open()) //Verify that the file is open.
     {
-      ReadData(Input, DataList);
+      //The columns after applying the default uncertainties and LowField, either mapped from the cache or parsed.
+      Columns.assign(DataCacheObject::NColumns, std::vector<double>());
+      DataCacheObject Cache(FileName, {DefaultYieldUncertainty, DefaultEnergyUncertainty, DefaultFieldUncertainty, LowField});
+      if(UseDataCache && Cache.Load())
+      {
+	for(unsigned int c(0); c < DataCacheObject::NColumns; ++c) Columns.at(c).assign(Cache.GetColumn(c), Cache.GetColumn(c) + Cache.GetNRows());
+      }
+      else
+      {
+	unsigned int NErrors(0);
+	ReadData(FileName, DataList, DataCacheObject::NColumns, &NErrors);
+	for(unsigned int i(0); i < DataList.size(); i+=9) //Parse and store the data.
+	{
+	  if(i + 8 < DataList.size())
+	  {
+	    Columns.at(0).push_back(DataList.at(i+0));
+	    Columns.at(1).push_back(DataList.at(i+1) == 0 ? DataList.at(i+0)*DefaultEnergyUncertainty : DataList.at(i+1));
+	    Columns.at(2).push_back(DataList.at(i+2) == 0 ? DataList.at(i+0)*DefaultEnergyUncertainty : DataList.at(i+2));
+	    if(DataList.at(i+3) == 0) DataList.at(i+3) = LowField; //Null field doesn't work with every model, so use the default "low" field value instead for null field points.
+	    Columns.at(3).push_back(DataList.at(i+3));
+	    Columns.at(4).push_back(DataList.at(i+4) == 0 ? DataList.at(i+3)*DefaultFieldUncertainty : DataList.at(i+4));
+	    Columns.at(5).push_back(DataList.at(i+5) == 0 ? DataList.at(i+3)*DefaultFieldUncertainty : DataList.at(i+5));
+	    Columns.at(6).push_back(DataList.at(i+6));
+	    Columns.at(7).push_back(DataList.at(i+7) == 0 ? DataList.at(i+6)*DefaultYieldUncertainty : DataList.at(i+7));
+	    Columns.at(8).push_back(DataList.at(i+8) == 0 ? DataList.at(i+6)*DefaultYieldUncertainty : DataList.at(i+8));
+	  }
+	  else
+	  {
+	    std::cerr << "Data file configured incorrectly. Check for a missing entry in a column." << std::endl;
+	    ++NErrors;
+	  }
+	}
+	if(UseDataCache && NErrors == 0) Cache.Save(Columns); //Otherwise the rows left out would be cached too, and not reported again.
+	else if(UseDataCache) std::cerr << "DataObject::DataObject(): " << FileName << " was not cached, since it has rows that could not be read." << std::endl;
+      }
       Input.close(); //Close the input file.
 
       //Process DataList using Recipes list.
@@ -43,14 +87,25 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
       {
 	//Process recipe.
 	substr = Recipes.at(set);
-	FuncObject.reset(new FunctionObject("ModelDefinitions.txt", substr.substr(0,substr.length()-1), stoi(substr.substr(substr.length()-1, 1)), success));
+	FuncObject.reset(new FunctionObject(FunctionDefinitions, substr.substr(0,substr.length()-1), stoi(substr.substr(substr.length()-1, 1)), success));
 	if(success)
 	{
-	  RecipeModel.reset(new TF2("RecipeModel", (FuncObject->GetFunction()+ "+0*y").c_str(), 0, 1000, 0, 5000));
+	  bool Built(false);
+	  if(FormulaCache != "") CompiledRecipe.reset(new CompiledFunctionObject(FuncObject->GetFunction(), FormulaCache, FormulaCompiler, Built));
+	  std::string RecipeName("RecipeModel" + substr + "_" + std::to_string(NRecipeModels++)); //Unique, as data of several ModelTypes may be loaded concurrently.
+	  if(Built) RecipeModel.reset(new TF2(RecipeName.c_str(), CompiledRecipe->GetFunction(), 0, 1000, 0, 5000, CompiledRecipe->GetNPar()));
+	  else RecipeModel.reset(new TF2(RecipeName.c_str(), (FuncObject->GetFunction()+ "+0*y").c_str(), 0, 1000, 0, 5000));
 	  recipe=true;
-	  Input.open(substr + "Log.txt");
-	  npar = ReadData(Input, ModelPieces);
-	  Input.close();
+	  if(RecipeResults.count(substr)) //Given by the caller, e.g. fit earlier in the same run.
+	  {
+	    npar = RecipeResults.at(substr).Parameters.size();
+	    ModelPieces = RecipeResults.at(substr).Parameters;
+	    ModelPieces.insert(ModelPieces.end(), RecipeResults.at(substr).Covariance.begin(), RecipeResults.at(substr).Covariance.end());
+	  }
+	  else
+	  {
+	    npar = ReadData(substr + "Log.txt", ModelPieces);
+	  }
 	  ModelCovariance.ResizeTo(npar,npar);
 	  for(unsigned int par(0); par < npar; ++par) RecipeModel->SetParameter(par, ModelPieces.at(par));
 	  for(unsigned int i(0); i < npar; ++i) for(unsigned int j(0); j < npar; ++j) ModelCovariance(i,j) = ModelPieces.at(npar*(1+i)+j);
@@ -58,24 +113,16 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
 	else std::cerr << "Improper model configuration when processing dataset recipes." << std::endl;
       }
 
-      for(unsigned int i(0); i < DataList.size(); i+=9) //Parse and store the data.
-      {
-	if(i + 8 < DataList.size())
-	{
-	  TMPDataX.push_back(DataList.at(i+0));
-	  TMPDataXErrLow.push_back(DataList.at(i+1) == 0 ? DataList.at(i+0)*DefaultEnergyUncertainty : DataList.at(i+1));
-	  TMPDataXErrHigh.push_back(DataList.at(i+2) == 0 ? DataList.at(i+0)*DefaultEnergyUncertainty : DataList.at(i+2));
-	  if(DataList.at(i+3) == 0) DataList.at(i+3) = LowField; //Null field doesn't work with every model, so use the default "low" field value instead for null field points.
-	  TMPDataY.push_back(DataList.at(i+3));
-	  TMPDataYErrLow.push_back(DataList.at(i+4) == 0 ? DataList.at(i+3)*DefaultFieldUncertainty : DataList.at(i+4));
-	  TMPDataYErrHigh.push_back(DataList.at(i+5) == 0 ? DataList.at(i+3)*DefaultFieldUncertainty : DataList.at(i+5));
-	  if(recipe) TMPDataZ.push_back(RecipeModel->Eval(TMPDataX.back(), TMPDataY.back()) - DataList.at(i+6));
-	  else TMPDataZ.push_back(DataList.at(i+6));
-	  TMPDataZErrLow.push_back(DataList.at(i+7) == 0 ? DataList.at(i+6)*DefaultYieldUncertainty : DataList.at(i+7));
-	  TMPDataZErrHigh.push_back(DataList.at(i+8) == 0 ? DataList.at(i+6)*DefaultYieldUncertainty : DataList.at(i+8));
-	}
-	else std::cerr << "Data file configured incorrectly. Check for a missing entry in a column." << std::endl;
-      }
+      TMPDataX = Columns.at(0);
+      TMPDataXErrLow = Columns.at(1);
+      TMPDataXErrHigh = Columns.at(2);
+      TMPDataY = Columns.at(3);
+      TMPDataYErrLow = Columns.at(4);
+      TMPDataYErrHigh = Columns.at(5);
+      TMPDataZ = Columns.at(6); //The yield, or what the recipe model leaves of it.
+      if(recipe) for(unsigned int i(0); i < TMPDataZ.size(); ++i) TMPDataZ.at(i) = RecipeModel->Eval(TMPDataX.at(i), TMPDataY.at(i)) - TMPDataZ.at(i);
+      TMPDataZErrLow = Columns.at(7);
+      TMPDataZErrHigh = Columns.at(8);
       DataVector.push_back(TMPDataX);
       DataVector.push_back(TMPDataXErrLow);
       DataVector.push_back(TMPDataXErrHigh);
@@ -87,19 +134,22 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
       DataVector.push_back(TMPDataZErrHigh);
       if(recipe)
       {
-	SetCovariances.push_back(BuildCovariance(DataVector, ModelCovariance));
+	CovarianceBlocks.push_back(BuildCovariance(DataVector, ModelCovariance));
+	const CovarianceBlock& Block(CovarianceBlocks.back());
 	for(unsigned int l(0); l < TMPDataX.size(); ++l)
 	{
-	  DataVector.at(7).at(l) = sqrt(SetCovariances.back()(l,l));
+	  double Variance(Block.Diagonal.at(l));
+	  for(unsigned int k(0); k < Block.Rank; ++k) Variance += Block.Factor.at(l*Block.Rank+k)*Block.Factor.at(l*Block.Rank+k);
+	  DataVector.at(7).at(l) = sqrt(Variance);
 	  DataVector.at(8).at(l) = DataVector.at(7).at(l);
 	}
       }
       else
       {
-	ModelCovariance.Clear();
-	ModelCovariance.ResizeTo(TMPDataX.size(), TMPDataX.size());
-	for(unsigned int l(0); l < TMPDataX.size(); ++l) ModelCovariance(l,l) = pow((TMPDataZErrLow.at(l) + TMPDataZErrHigh.at(l))/2.0, 2.0);
-	SetCovariances.push_back(ModelCovariance);
+	CovarianceBlock Block;
+	Block.Rank = 0; //Independent points.
+	for(unsigned int l(0); l < TMPDataX.size(); ++l) Block.Diagonal.push_back(pow((TMPDataZErrLow.at(l) + TMPDataZErrHigh.at(l))/2.0, 2.0));
+	CovarianceBlocks.push_back(Block);
       }
     }
     for(unsigned int k(0); k < TMPDataX.size(); ++k)
@@ -114,8 +164,6 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
       DataZErrLow.push_back(DataVector.at(7).at(k));
       DataZErrHigh.push_back(DataVector.at(8).at(k));
     }
-    Covariance.ResizeTo(DataX.size(),DataX.size());
-    Covariance.SetSub(DataX.size() - TMPDataX.size(), DataX.size() - TMPDataX.size(), SetCovariances.back());
     TMPDataX.clear();
     TMPDataXErrLow.clear();
     TMPDataXErrHigh.clear();
@@ -128,46 +176,92 @@ DataObject::DataObject(std::vector<std::string> Sets, std::vector<std::string> R
     DataList.clear();
     DataVector.clear();
   }
+  CovarianceFactor = CovarianceObject(CovarianceBlocks, Valid); //Factorize once here, so that every model sharing this data can reuse it.
+}
+
+DataObject::DataObject(const DataObject& Nominal, const std::vector<unsigned int>& Multiplicity)
+{
+  //Point i of Nominal is used Multiplicity[i] times. A point used m times is kept once, with its errors (and its
+  //rows and columns of the covariance) divided by sqrt(m): that gives the same chi-square as m copies of it,
+  //without making the covariance singular. Points used 0 times, and blocks left empty, are dropped.
+  unsigned int Offset(0);
+  for(unsigned int b(0); b < Nominal.CovarianceBlocks.size(); ++b)
+  {
+    const CovarianceBlock& Block(Nominal.CovarianceBlocks.at(b));
+    unsigned int Size(Block.Diagonal.size());
+    CovarianceBlock Resampled;
+    Resampled.Rank = Block.Rank;
+    for(unsigned int i(0); i < Size; ++i)
+    {
+      if(Multiplicity.at(Offset+i) == 0) continue;
+      double Scale(1.0/std::sqrt(Multiplicity.at(Offset+i)));
+      unsigned int k(Offset + i);
+      Resampled.Diagonal.push_back(Block.Diagonal.at(i)*Scale*Scale); //S*(D + U*U^T)*S = S*D*S + (S*U)*(S*U)^T.
+      for(unsigned int r(0); r < Block.Rank; ++r) Resampled.Factor.push_back(Block.Factor.at(i*Block.Rank+r)*Scale);
+      DataX.push_back(Nominal.DataX.at(k));
+      DataXErrLow.push_back(Nominal.DataXErrLow.at(k)*Scale);
+      DataXErrHigh.push_back(Nominal.DataXErrHigh.at(k)*Scale);
+      DataY.push_back(Nominal.DataY.at(k));
+      DataYErrLow.push_back(Nominal.DataYErrLow.at(k)*Scale);
+      DataYErrHigh.push_back(Nominal.DataYErrHigh.at(k)*Scale);
+      DataZ.push_back(Nominal.DataZ.at(k));
+      DataZErrLow.push_back(Nominal.DataZErrLow.at(k)*Scale);
+      DataZErrHigh.push_back(Nominal.DataZErrHigh.at(k)*Scale);
+    }
+    if(!Resampled.Diagonal.empty()) CovarianceBlocks.push_back(Resampled);
+    Offset += Size;
+  }
+  CovarianceFactor = CovarianceObject(CovarianceBlocks, Valid);
+}
+
+const std::vector<CovarianceBlock>& DataObject::GetCovarianceBlocks() const
+{
+  return CovarianceBlocks;
 }
 
-TMatrixT<double> DataObject::GetCovariance()
+const CovarianceObject& DataObject::GetCovarianceFactor() const
 {
-  return Covariance;
+  return CovarianceFactor;
 }
 
-std::vector<double> DataObject::GetDataX()
+bool DataObject::IsValid() const
+{
+  return Valid;
+}
+
+const std::vector<double>& DataObject::GetDataX() const
 {
   return DataX;
 }
-std::vector<double> DataObject::GetDataXErrLow()
+const std::vector<double>& DataObject::GetDataXErrLow() const
 {
   return DataXErrLow;
 }
-std::vector<double> DataObject::GetDataXErrHigh()
+const std::vector<double>& DataObject::GetDataXErrHigh() const
 {
   return DataXErrHigh;
 }
-std::vector<double> DataObject::GetDataY()
+const std::vector<double>& DataObject::GetDataY() const
 {
   return DataY;
 }
-std::vector<double> DataObject::GetDataYErrLow()
+const std::vector<double>& DataObject::GetDataYErrLow() const
 {
   return DataYErrLow;
 }
-std::vector<double> DataObject::GetDataYErrHigh()
+const std::vector<double>& DataObject::GetDataYErrHigh() const
 {
   return DataYErrHigh;
 }
-std::vector<double> DataObject::GetDataZ()
+const std::vector<double>& DataObject::GetDataZ() const
 {
   return DataZ;
 }
-std::vector<double> DataObject::GetDataZErrLow()
+const std::vector<double>& DataObject::GetDataZErrLow() const
 {
   return DataZErrLow;
 }
-std::vector<double> DataObject::GetDataZErrHigh()
+const std::vector<double>& DataObject::GetDataZErrHigh() const
 {
   return DataZErrHigh;
 }
@@ -189,79 +283,62 @@ std::ostream &operator<< (std::ostream &out, const DataObject &Obj)
   return out;
 }
 
-TMatrixT<double> DataObject::BuildCovariance(std::vector< std::vector<double> > Data, TMatrixT<double> V_P)
+CovarianceBlock DataObject::BuildCovariance(const std::vector< std::vector<double> >& Data, const TMatrixT<double>& V_P)
 {
-  int N(Data.at(0).size()), P(RecipeModel->GetNpar());
-  TMatrixT<double> V_N(N,N);
-  TMatrixT<double> V_E(N,N);
-  TMatrixT<double> V_F(N,N);
-  TMatrixT<double> V_x(3*N+P, 3*N+P);
-  TMatrixT<double> G_N(N,N);
-  TMatrixT<double> G_E(N,N);
-  TMatrixT<double> G_F(N,N);
-  TMatrixT<double> G_P(P,P);
-  TMatrixT<double> G(N,3*N+P);
-  TMatrixT<double> V_f(N,N);
+  //Each point is t_i = f(E_i, F_i; p) - n_i, with independent uncertainties on n_i, E_i and F_i, and the covariance
+  //V_P of the recipe parameters p. Propagating them gives V_t = G_N*V_N*G_N^T + G_E*V_E*G_E^T + G_F*V_F*G_F^T
+  //+ G_P*V_P*G_P^T: the first three terms are diagonal, and the last one is U*U^T with U = G_P*C for any
+  //V_P = C*C^T, so the block is stored as a diagonal plus a rank P term rather than an N x N matrix.
+  int N(Data.at(0).size()), P(std::min(V_P.GetNrows(), RecipeModel->GetNpar()));
   double x[2];
-  double *p;
+  double *p(RecipeModel->GetParameters());
+  std::vector<double> C(Cholesky(V_P, P));
+  unsigned int Rank(P > 0 ? C.size()/P : 0);
+  CovarianceBlock Block;
+  Block.Rank = Rank;
+  Block.Diagonal.resize(N);
+  Block.Factor.assign(N*Rank, 0);
+  std::vector<double> G_P(P);
 
   for(unsigned int i(0); i < N; ++i)
   {
-    V_N(i,i) = pow((Data.at(7).at(i) + Data.at(8).at(i))/2.0, 2.0);
-    V_E(i,i) = pow((Data.at(1).at(i) + Data.at(2).at(i))/2.0, 2.0);
-    V_F(i,i) = pow((Data.at(4).at(i) + Data.at(5).at(i))/2.0, 2.0);
-    G_N(i,i) = -1.0;    
+    x[0] = Data.at(0).at(i);
+    x[1] = Data.at(3).at(i);
+    double G_E(Derivative(x, p, 0)), G_F(Derivative(x, p, 1));
+    Block.Diagonal.at(i) = pow((Data.at(7).at(i) + Data.at(8).at(i))/2.0, 2.0) //G_N = -1.
+      + G_E*G_E*pow((Data.at(1).at(i) + Data.at(2).at(i))/2.0, 2.0)
+      + G_F*G_F*pow((Data.at(4).at(i) + Data.at(5).at(i))/2.0, 2.0);
+    for(unsigned int j(0); j < P; ++j) G_P.at(j) = Derivative(x, p, j+2);
+    for(unsigned int r(0); r < Rank; ++r) for(unsigned int j(0); j < P; ++j) Block.Factor.at(i*Rank+r) += G_P.at(j)*C.at(j*Rank+r);
   }
-  //std::cerr << "V_N" << std::endl;
-  //V_N.Print();
-  //std::cerr << "V_E" << std::endl;
-  //V_E.Print();
-  //std::cerr << "V_F" << std::endl;
-  //V_F.Print();
-  //std::cerr << "V_P" << std::endl;
-  //V_P.Print();
-  //std::cerr << "G_N" << std::endl;
-  //G_N.Print();
-  V_x.SetSub(0,0, V_N);
-  V_x.SetSub(N,N, V_E);
-  V_x.SetSub(2*N,2*N, V_F);
-  V_x.SetSub(3*N,3*N, V_P);
-  //std::cerr << "V_x" << std::endl;
-  //V_x.Print();
-  for(unsigned int i(0); i < N; ++i)
+  return Block;
+}
+
+std::vector<double> DataObject::Cholesky(const TMatrixT<double>& V, unsigned int P)
+{
+  //C with V = C*C^T, P x Rank row by row. Columns with no variance left (e.g. fixed parameters, whose rows of
+  //the covariance are 0) are dropped, so that the rank is only that of V.
+  std::vector< std::vector<double> > Columns;
+  double Largest(0);
+  for(unsigned int i(0); i < P; ++i) Largest = std::max(Largest, V(i,i));
+  for(unsigned int j(0); j < P; ++j)
   {
-    for(unsigned int j(0); j < N; ++j)
+    std::vector<double> Column(P, 0);
+    double Pivot(V(j,j));
+    for(unsigned int c(0); c < Columns.size(); ++c) Pivot -= Columns.at(c).at(j)*Columns.at(c).at(j);
+    if(!(Pivot > 1e-12*Largest)) continue;
+    Pivot = sqrt(Pivot);
+    for(unsigned int i(j); i < P; ++i)
     {
-      //dt_i/dE_j
-      p = RecipeModel->GetParameters();
-      x[0] = Data.at(0).at(i);
-      x[1] = Data.at(3).at(i);
-      G_E(i,j) = i == j ? Derivative(x, p, 0) : 0;
-      G_F(i,j) = i == j ? Derivative(x, p, 1) : 0;
+      double Sum(0.5*(V(i,j) + V(j,i)));
+      for(unsigned int c(0); c < Columns.size(); ++c) Sum -= Columns.at(c).at(i)*Columns.at(c).at(j);
+      Column.at(i) = Sum/Pivot;
     }
-    if(i < P) for(unsigned int j(0); j < P; ++j) G_P(i,j) = Derivative(x, p, j+2);
+    Columns.push_back(Column);
   }
-  //std::cerr << "G_E" << std::endl;
-  //G_E.Print();
-  //std::cerr << "G_F" << std::endl;
-  //G_F.Print();
-  //std::cerr << "G_P" << std::endl;
-  //G_P.Print();
-  G.SetSub(0,0, G_N);
-  G.SetSub(0,N, G_E);
-  G.SetSub(0,2*N, G_F);
-  G.SetSub(0,3*N, G_P);
-  //std::cerr << "G" << std::endl;
-  //G.Print();
-
-  TMatrixT<double> VG(3*N+P, N);
-  VG.MultT(V_x, G);
-  //std::cerr << "VGT" << std::endl;
-  //VG.Print();
-  V_f.Mult(G, VG);
-  //std::cerr << "V_f" << std::endl;
-  //V_f.Print();
-  return V_f;
+  std::vector<double> C(P*Columns.size());
+  for(unsigned int i(0); i < P; ++i) for(unsigned int c(0); c < Columns.size(); ++c) C.at(i*Columns.size()+c) = Columns.at(c).at(i);
+  return C;
 }
 
 double DataObject::Derivative(double* x, double* p, int axis)
@@ -312,38 +389,17 @@ double DataObject::Derivative(double* x, double* p, int axis)
   return CalculatedValue;
 }
 
-int DataObject::ReadData(std::ifstream &Input, std::vector<double> &List)
+int DataObject::ReadData(std::string FileName, std::vector<double> &List, unsigned int Columns, unsigned int* NErrors)
 {
-  List.clear();
-  int prev, pos, columns(0);
-  bool first_iteration(true);
-  std::string line;
-  if(Input.is_open())
+  CSVReaderObject Reader(FileName);
+  if(!Reader.IsOpen())
   {
-    while(std::getline(Input, line)) //Loop over each line in the data file.
-    {
-      prev = 0;
-      if(line[0] != '#') //Ignore lines starting with a '#' (comment).
-      {
-	while( (pos = line.find_first_of(",", prev)) != std::string::npos) //This loop grabs strings delimited by a ','.
-	{
-	  if(pos > prev)
-	  {
-	    List.push_back( stof(line.substr(prev, pos-prev)) );
-	    if(first_iteration) ++columns;
-	  }
-	  prev = pos + 1;
-	}
-	if(prev < line.length())
-	{
-	  List.push_back( stof(line.substr(prev, std::string::npos)) );
-	  if(first_iteration) ++columns;
-	}
-	first_iteration = false;
-      }
-      else prev += line.size();
-    }
+    std::cerr << "File not found when reading in data." << std::endl;
+    List.clear();
+    if(NErrors) *NErrors = 1;
+    return 0;
   }
-  else std::cerr << "File not found when reading in data." << std::endl;
-  return columns;
+  int NColumns(Reader.Read(List, Columns));
+  if(NErrors) *NErrors = Reader.GetNErrors();
+  return NColumns;
 }
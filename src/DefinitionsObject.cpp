@@ -0,0 +1,76 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads the definitions file.
+#include <iostream> //Basic input and output.
+#include <map> //Definitions already loaded.
+#include <mutex> //Models may be constructed concurrently.
+
+//Custom includes.
+#include "DefinitionsObject.h" //Header file for this implementation.
+
+std::shared_ptr<const DefinitionsObject> DefinitionsObject::Get(std::string FileName)
+{
+  static std::mutex LoadedMutex;
+  static std::map< std::string, std::shared_ptr<const DefinitionsObject> > Loaded;
+  std::lock_guard<std::mutex> Lock(LoadedMutex);
+  std::shared_ptr<const DefinitionsObject>& Definitions(Loaded[FileName]);
+  if(!Definitions) Definitions.reset(new DefinitionsObject(FileName));
+  return Definitions;
+}
+
+DefinitionsObject::DefinitionsObject(std::string FileName)
+{
+  std::ifstream Input(FileName);
+  std::string Line;
+  std::size_t Colon, First, Last;
+  Open = Input.is_open();
+  if(!Open) std::cerr << "DefinitionsObject::DefinitionsObject(): Definitions file " << FileName << " not found." << std::endl;
+  while(std::getline(Input, Line))
+  {
+    Colon = Line.find(":");
+    if(Line.length() == 0 || Line[0] == '#' || Colon == std::string::npos) continue; //Skip comments and lines without a key.
+    First = Line.find("\"", Colon);
+    if(First == std::string::npos)
+    {
+      std::cerr << "DefinitionsObject::DefinitionsObject(): The value of " << Line.substr(0, Colon) << " in " << FileName << " is not quoted." << std::endl;
+      continue;
+    }
+    Last = Line.find("\"", First+1); //Without a closing quote, the value is the rest of the line.
+    if(Last == std::string::npos) Last = Line.length();
+    std::string Key(Line.substr(0, Colon));
+    if(!Entries.emplace(Key, Line.substr(First+1, Last-First-1)).second) std::cerr << "DefinitionsObject::DefinitionsObject(): " << Key << " is defined more than once in " << FileName << ", the first definition is used." << std::endl;
+    else Keys.push_back(Key);
+  }
+}
+
+bool DefinitionsObject::IsOpen() const
+{
+  return Open;
+}
+
+bool DefinitionsObject::Find(const std::string& Key, std::string& Value) const
+{
+  std::unordered_map<std::string, std::string>::const_iterator Entry(Entries.find(Key));
+  if(Entry == Entries.end()) return false;
+  Value = Entry->second;
+  return true;
+}
+
+bool DefinitionsObject::Find(const std::string& ModelType, const std::string& Field, unsigned int ModelID, std::string& Value) const
+{
+  return Find(ModelType + Field + std::to_string(ModelID), Value);
+}
+
+std::vector<unsigned int> DefinitionsObject::FindModelIDs(const std::string& ModelType) const
+{
+  std::vector<unsigned int> ModelIDs;
+  for(unsigned int k(0); k < Keys.size(); ++k)
+  {
+    const std::string& Key(Keys.at(k));
+    if(Key.compare(0, ModelType.length()+1, ModelType+std::string("F")) != 0 || Key.length() == ModelType.length()+1) continue; //Only function keys of this ModelType.
+    if(Key.find_first_not_of("0123456789", ModelType.length()+1) != std::string::npos) continue; //The rest of the key must be the ModelID.
+    ModelIDs.push_back(std::stoi(Key.substr(ModelType.length()+1)));
+  }
+  return ModelIDs;
+}
@@ -0,0 +1,543 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <cmath> //Scalar math, for the parameter-only part of the formula.
+#include <cstdlib> //For std::strtod.
+#include <cstring> //For std::memcpy.
+#include <cctype> //Character classes for the tokenizer.
+#include <algorithm> //For std::min, std::fill, std::sort, and std::binary_search.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "ExpressionObject.h" //Header file for this implementation.
+#include "VectorKernels.h" //Element-wise kernels.
+
+namespace
+{
+  void SkipSpaces(const std::string& Text, std::size_t& Position)
+  {
+    while(Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position]))) ++Position;
+  }
+
+  bool Accept(const std::string& Text, std::size_t& Position, char Character)
+  {
+    SkipSpaces(Text, Position);
+    if(Position < Text.size() && Text[Position] == Character)
+    {
+      ++Position;
+      return true;
+    }
+    return false;
+  }
+}
+
+ExpressionObject::ExpressionObject(std::string Expression, bool& Success)
+{
+  NPar = 0;
+  NSlots = 0;
+  HasY = false;
+  Kernels = &VectorKernels::Get();
+  std::size_t Position(0);
+  Root = ParseSum(Expression, Position);
+  SkipSpaces(Expression, Position);
+  Success = Root >= 0 && Position == Expression.size();
+  if(Success)
+  {
+    Dependencies.resize(Nodes.size());
+    for(unsigned int i(0); i < Nodes.size(); ++i) //Operands always come before the node using them.
+    {
+      if(Nodes[i].Op == Parameter) Dependencies[i].push_back(static_cast<unsigned int>(Nodes[i].Value));
+      std::vector<unsigned int> Merged;
+      if(Nodes[i].Left >= 0) Merged = Dependencies[Nodes[i].Left];
+      if(Nodes[i].Right >= 0) Merged.insert(Merged.end(), Dependencies[Nodes[i].Right].begin(), Dependencies[Nodes[i].Right].end());
+      std::sort(Merged.begin(), Merged.end());
+      Merged.erase(std::unique(Merged.begin(), Merged.end()), Merged.end());
+      if(Nodes[i].Op != Parameter) Dependencies[i] = Merged;
+    }
+    std::vector<unsigned int> FreeSlots;
+    Result = Compile(Root, FreeSlots);
+  }
+  else Nodes.clear();
+}
+
+int ExpressionObject::ParseSum(const std::string& Text, std::size_t& Position)
+{
+  int Left(ParseProduct(Text, Position));
+  while(Left >= 0)
+  {
+    if(Accept(Text, Position, '+')) Left = AddNode(Add, Left, ParseProduct(Text, Position), 0);
+    else if(Accept(Text, Position, '-')) Left = AddNode(Subtract, Left, ParseProduct(Text, Position), 0);
+    else break;
+  }
+  return Left;
+}
+
+int ExpressionObject::ParseProduct(const std::string& Text, std::size_t& Position)
+{
+  int Left(ParseUnary(Text, Position));
+  while(Left >= 0)
+  {
+    if(Accept(Text, Position, '*')) Left = AddNode(Multiply, Left, ParseUnary(Text, Position), 0);
+    else if(Accept(Text, Position, '/')) Left = AddNode(Divide, Left, ParseUnary(Text, Position), 0);
+    else break;
+  }
+  return Left;
+}
+
+int ExpressionObject::ParseUnary(const std::string& Text, std::size_t& Position)
+{
+  if(Accept(Text, Position, '-')) return AddNode(Negate, ParseUnary(Text, Position), -1, 0);
+  if(Accept(Text, Position, '+')) return ParseUnary(Text, Position);
+  return ParsePower(Text, Position);
+}
+
+int ExpressionObject::ParsePower(const std::string& Text, std::size_t& Position)
+{
+  int Base(ParsePrimary(Text, Position));
+  if(Base >= 0 && Accept(Text, Position, '^')) return AddNode(Power, Base, ParseUnary(Text, Position), 0); //Right associative.
+  return Base;
+}
+
+int ExpressionObject::ParsePrimary(const std::string& Text, std::size_t& Position)
+{
+  SkipSpaces(Text, Position);
+  if(Position >= Text.size()) return -1;
+  char Character(Text[Position]);
+  if(Character == '(')
+  {
+    ++Position;
+    int Inner(ParseSum(Text, Position));
+    return Accept(Text, Position, ')') ? Inner : -1;
+  }
+  if(Character == '[') //Parameter.
+  {
+    std::size_t Close(Text.find(']', Position));
+    if(Close == std::string::npos || Close == Position+1) return -1;
+    std::string Index(Text.substr(Position+1, Close-Position-1));
+    if(Index.find_first_not_of("0123456789") != std::string::npos) return -1;
+    Position = Close+1;
+    unsigned int Number(std::stoul(Index));
+    NPar = std::max(NPar, Number+1);
+    return AddNode(Parameter, -1, -1, Number);
+  }
+  if(std::isdigit(static_cast<unsigned char>(Character)) || Character == '.') //Number, including forms like "1." and "2e3".
+  {
+    const char* Start(Text.c_str() + Position);
+    char* End(nullptr);
+    double Value(std::strtod(Start, &End));
+    if(End == Start) return -1;
+    bool Integer(std::string(Start, static_cast<const char*>(End)).find_first_of(".eEnNxX") == std::string::npos); //An int in C++, like "2" but not "2." or "2e0".
+    Position += End - Start;
+    return AddNode(Constant, -1, -1, Value, Integer);
+  }
+  if(std::isalpha(static_cast<unsigned char>(Character)) || Character == '_')
+  {
+    std::size_t End(Position);
+    while(End < Text.size() && (std::isalnum(static_cast<unsigned char>(Text[End])) || Text[End] == '_' || Text[End] == ':')) ++End;
+    std::string Name(Text.substr(Position, End-Position));
+    Position = End;
+    if(Name == "x") return AddNode(VariableX, -1, -1, 0);
+    if(Name == "y")
+    {
+      HasY = true;
+      return AddNode(VariableY, -1, -1, 0);
+    }
+    Operation Function;
+    unsigned int NArgs(1);
+    if(Name == "TMath::Power" || Name == "pow")
+    {
+      Function = Power;
+      NArgs = 2;
+    }
+    else if(Name == "TMath::Exp" || Name == "exp") Function = Exponential;
+    else if(Name == "TMath::Log" || Name == "log") Function = Logarithm;
+    else if(Name == "TMath::Sqrt" || Name == "sqrt") Function = SquareRoot;
+    else if(Name == "TMath::Abs" || Name == "abs" || Name == "fabs") Function = Absolute;
+    else return -1; //Unknown name, left to TFormula.
+    if(!Accept(Text, Position, '(')) return -1;
+    int First(ParseSum(Text, Position));
+    int Second(-1);
+    if(NArgs == 2 && (First < 0 || !Accept(Text, Position, ','))) return -1;
+    if(NArgs == 2) Second = ParseSum(Text, Position);
+    if(First < 0 || (NArgs == 2 && Second < 0) || !Accept(Text, Position, ')')) return -1;
+    return AddNode(Function, First, Second, 0);
+  }
+  return -1;
+}
+
+int ExpressionObject::AddNode(Operation Op, int Left, int Right, double Value, bool Integer)
+{
+  bool Binary(Op == Add || Op == Subtract || Op == Multiply || Op == Divide || Op == Power);
+  if(Op != Constant && Op != Parameter && Op != VariableX && Op != VariableY) //Operation, so check its operands.
+  {
+    if(Left < 0 || (Binary && Right < 0)) return -1;
+    //Only literals are ints, so an int operand is always a constant. "1/2" is 0 in C++ and TFormula, which
+    //evaluate every operation in double here, so such formulas are left to TFormula.
+    bool IntegerOperands(Nodes.at(Left).Integer && (!Binary || Nodes.at(Right).Integer));
+    if(Op == Divide && IntegerOperands) return -1;
+    if(Nodes.at(Left).Op == Constant && (!Binary || Nodes.at(Right).Op == Constant)) //Fold constants.
+    {
+      double Folded(Apply(Op, Nodes.at(Left).Value, Binary ? Nodes.at(Right).Value : 0));
+      return AddNode(Constant, -1, -1, Folded, IntegerOperands && (Op == Add || Op == Subtract || Op == Multiply || Op == Negate));
+    }
+  }
+  Node NewNode;
+  NewNode.Op = Op;
+  NewNode.Left = Left;
+  NewNode.Right = Right;
+  NewNode.Value = Value;
+  NewNode.Integer = Op == Constant && Integer;
+  NewNode.Uniform = Op != VariableX && Op != VariableY && (Left < 0 || Nodes.at(Left).Uniform) && (Right < 0 || Nodes.at(Right).Uniform);
+  Nodes.push_back(NewNode);
+  return Nodes.size()-1;
+}
+
+unsigned int ExpressionObject::CompileUniform(int Index)
+{
+  const Node& Current(Nodes.at(Index));
+  UniformStep Step;
+  Step.Op = Current.Op;
+  Step.Left = Current.Left >= 0 ? CompileUniform(Current.Left) : 0;
+  Step.Right = Current.Right >= 0 ? CompileUniform(Current.Right) : 0;
+  Step.Value = Current.Value;
+  UniformSteps.push_back(Step);
+  return UniformSteps.size()-1;
+}
+
+unsigned int ExpressionObject::NewSlot(std::vector<unsigned int>& FreeSlots)
+{
+  if(FreeSlots.empty()) return NSlots++;
+  unsigned int Free(FreeSlots.back());
+  FreeSlots.pop_back();
+  return Free;
+}
+
+ExpressionObject::Operand ExpressionObject::Compile(int Index, std::vector<unsigned int>& FreeSlots)
+{
+  const Node& Current(Nodes.at(Index));
+  Operand Compiled;
+  Compiled.Node = Index;
+  if(Current.Uniform)
+  {
+    Compiled.Kind = Uniform;
+    Compiled.Index = CompileUniform(Index);
+    return Compiled;
+  }
+  if(Current.Op == VariableX || Current.Op == VariableY)
+  {
+    Compiled.Kind = Current.Op == VariableX ? ArrayX : ArrayY;
+    Compiled.Index = 0;
+    return Compiled;
+  }
+  VectorStep Step;
+  Step.Op = Current.Op;
+  Step.Node = Index;
+  Step.A = Compile(Current.Left, FreeSlots);
+  Step.B = Step.A; //Unused by unary steps.
+  if(Current.Right >= 0)
+  {
+    const Node& Exponent(Nodes.at(Current.Right));
+    if(Current.Op == Power && Exponent.Op == Constant && Exponent.Value == 1) return Step.A;
+    if(Current.Op == Power && Exponent.Op == Constant && Exponent.Value == 2) Step.Op = Square; //Exact, and much cheaper than exp(2*log(a)).
+    else if(Current.Op == Power && Exponent.Op == Constant && Exponent.Value == 0.5) Step.Op = SquareRoot;
+    else Step.B = Compile(Current.Right, FreeSlots);
+    if((Step.Op == Add || Step.Op == Multiply) && Step.A.Kind == Uniform) std::swap(Step.A, Step.B); //Commutative, so only the VU kernel is needed.
+  }
+  //The result gets a slot before the operands release theirs, so a kernel never writes over its input.
+  Step.Out = NewSlot(FreeSlots);
+  if(Step.A.Kind == Slot) FreeSlots.push_back(Step.A.Index);
+  if(Step.Op != Square && Step.Op != SquareRoot && Current.Right >= 0 && Step.B.Kind == Slot) FreeSlots.push_back(Step.B.Index);
+  VectorSteps.push_back(Step);
+  Compiled.Kind = Slot;
+  Compiled.Index = Step.Out;
+  return Compiled;
+}
+
+double ExpressionObject::Apply(Operation Op, double a, double b)
+{
+  switch(Op)
+  {
+  case Add: return a + b;
+  case Subtract: return a - b;
+  case Multiply: return a * b;
+  case Divide: return a / b;
+  case Power: return std::pow(a, b);
+  case Negate: return -a;
+  case Exponential: return std::exp(a);
+  case Logarithm: return std::log(a);
+  case SquareRoot: return std::sqrt(a);
+  case Absolute: return std::fabs(a);
+  case Square: return a * a;
+  default: return 0;
+  }
+}
+
+double ExpressionObject::Derivative(Operation Op, double a, double b, double c, double da, double db)
+{
+  //Derivative of c = Op(a, b), given those of a and b. Terms with a zero derivative are skipped, so that
+  //e.g. the derivative of a^b with respect to b alone is finite at a = 0.
+  switch(Op)
+  {
+  case Add: return da + db;
+  case Subtract: return da - db;
+  case Multiply: return da*b + a*db;
+  case Divide: return std::isinf(b) && std::isfinite(a) ? 0 : (da - c*db)/b; //An overflowed denominator (e.g. a large power) gives c = 0 in its neighbourhood too.
+  case Power: return (da != 0 ? c*b*da/a : 0) + (db != 0 ? c*std::log(a)*db : 0);
+  case Negate: return -da;
+  case Exponential: return c*da;
+  case Logarithm: return da/a;
+  case SquareRoot: return 0.5*da/c;
+  case Absolute: return a < 0 ? -da : da;
+  case Square: return 2*a*da;
+  default: return 0;
+  }
+}
+
+const double* ExpressionObject::Resolve(const Operand& Op, const double* X, const double* Y, const double* Uniforms, const double* Slots, unsigned int Start) const
+{
+  if(Op.Kind == ArrayX) return X + Start;
+  if(Op.Kind == ArrayY) return Y + Start;
+  if(Op.Kind == Slot) return Slots + Op.Index*BlockSize;
+  return Uniforms + Op.Index;
+}
+
+void ExpressionObject::EvaluateUniforms(const double* p, double* Uniforms) const
+{
+  for(unsigned int i(0); i < UniformSteps.size(); ++i)
+  {
+    const UniformStep& Step(UniformSteps[i]);
+    if(Step.Op == Constant) Uniforms[i] = Step.Value;
+    else if(Step.Op == Parameter) Uniforms[i] = p[static_cast<unsigned int>(Step.Value)];
+    else Uniforms[i] = Apply(Step.Op, Uniforms[Step.Left], Uniforms[Step.Right]);
+  }
+}
+
+void ExpressionObject::Run(const VectorStep& Step, const double* X, const double* Y, const double* Uniforms, double* Slots, unsigned int Start, unsigned int n) const
+{
+  const VectorKernels& K(*Kernels);
+  const double* A(Resolve(Step.A, X, Y, Uniforms, Slots, Start));
+  double* Output(Slots + Step.Out*BlockSize);
+  switch(Step.Op)
+  {
+  case Negate: K.Neg(A, Output, n); break;
+  case Exponential: K.Exp(A, Output, n); break;
+  case Logarithm: K.Log(A, Output, n); break;
+  case SquareRoot: K.Sqrt(A, Output, n); break;
+  case Absolute: K.Abs(A, Output, n); break;
+  case Square: K.Square(A, Output, n); break;
+  default: //Binary, where at most one operand is uniform.
+    {
+      const double* B(Resolve(Step.B, X, Y, Uniforms, Slots, Start));
+      bool UniformA(Step.A.Kind == Uniform), UniformB(Step.B.Kind == Uniform);
+      switch(Step.Op)
+      {
+      case Add:
+	if(UniformB) K.AddVU(A, *B, Output, n);
+	else K.AddVV(A, B, Output, n);
+	break;
+      case Multiply:
+	if(UniformB) K.MulVU(A, *B, Output, n);
+	else K.MulVV(A, B, Output, n);
+	break;
+      case Subtract:
+	if(UniformA) K.SubUV(*A, B, Output, n);
+	else if(UniformB) K.SubVU(A, *B, Output, n);
+	else K.SubVV(A, B, Output, n);
+	break;
+      case Divide:
+	if(UniformA) K.DivUV(*A, B, Output, n);
+	else if(UniformB) K.DivVU(A, *B, Output, n);
+	else K.DivVV(A, B, Output, n);
+	break;
+      case Power:
+	if(UniformA) K.PowUV(*A, B, Output, n);
+	else if(UniformB) K.PowVU(A, *B, Output, n);
+	else K.PowVV(A, B, Output, n);
+	break;
+      default:
+	break;
+      }
+    }
+  }
+}
+
+void ExpressionObject::Evaluate(const double* X, const double* Y, const double* p, double* Out, unsigned int N, double* Workspace) const
+{
+  //Parameter-only part, once per call.
+  double* Uniforms(Workspace);
+  EvaluateUniforms(p, Uniforms);
+  if(Result.Kind == Uniform)
+  {
+    std::fill(Out, Out+N, Uniforms[Result.Index]);
+    return;
+  }
+
+  //Everything that depends on x or y, one block at a time.
+  double* Slots(Workspace + UniformSteps.size());
+  for(unsigned int Start(0); Start < N; Start += BlockSize)
+  {
+    unsigned int n(std::min(BlockSize, N-Start));
+    for(unsigned int s(0); s < VectorSteps.size(); ++s) Run(VectorSteps[s], X, Y, Uniforms, Slots, Start, n);
+    std::memcpy(Out+Start, Resolve(Result, X, Y, Uniforms, Slots, Start), n*sizeof(double));
+  }
+}
+
+void ExpressionObject::EvaluateWithDerivatives(const double* X, const double* Y, const double* p, double* Out, double* OutX, double* OutY, unsigned int N, double* Workspace) const
+{
+  //f, df/dx, and df/dy in one pass, in forward mode: every step also propagates the derivatives of its
+  //result with respect to x and y. Exact, unlike a finite difference stencil, and ~3 evaluations' cost.
+  double* Uniforms(Workspace);
+  double* Slots(Uniforms + UniformSteps.size());
+  double* Tangents(Slots + NSlots*BlockSize); //d(slot s)/dx at 2*s*BlockSize, d(slot s)/dy right after.
+  EvaluateUniforms(p, Uniforms);
+  if(Result.Kind == Uniform)
+  {
+    std::fill(Out, Out+N, Uniforms[Result.Index]);
+    std::fill(OutX, OutX+N, 0.0);
+    std::fill(OutY, OutY+N, 0.0);
+    return;
+  }
+  for(unsigned int Start(0); Start < N; Start += BlockSize)
+  {
+    unsigned int n(std::min(BlockSize, N-Start));
+    for(unsigned int s(0); s < VectorSteps.size(); ++s)
+    {
+      const VectorStep& Step(VectorSteps[s]);
+      Run(Step, X, Y, Uniforms, Slots, Start, n);
+      bool UniformA(Step.A.Kind == Uniform), UniformB(Step.B.Kind == Uniform);
+      const double* A(Resolve(Step.A, X, Y, Uniforms, Slots, Start));
+      const double* B(Resolve(Step.B, X, Y, Uniforms, Slots, Start));
+      const double* C(Slots + Step.Out*BlockSize);
+      bool Unary(Step.Op != Add && Step.Op != Subtract && Step.Op != Multiply && Step.Op != Divide && Step.Op != Power);
+      for(unsigned int Direction(0); Direction < 2; ++Direction)
+      {
+	//Derivatives of the operands: an array for slots, 1 for the variable itself, and 0 otherwise.
+	OperandKind Variable(Direction == 0 ? ArrayX : ArrayY);
+	const double* dA(Step.A.Kind == Slot ? Tangents + (2*Step.A.Index+Direction)*BlockSize : nullptr);
+	const double* dB(!Unary && Step.B.Kind == Slot ? Tangents + (2*Step.B.Index+Direction)*BlockSize : nullptr);
+	double dAValue(Step.A.Kind == Variable ? 1 : 0), dBValue(!Unary && Step.B.Kind == Variable ? 1 : 0);
+	double* dC(Tangents + (2*Step.Out+Direction)*BlockSize);
+	for(unsigned int i(0); i < n; ++i) dC[i] = Derivative(Step.Op, UniformA ? *A : A[i], Unary ? 0 : (UniformB ? *B : B[i]), C[i], dA ? dA[i] : dAValue, dB ? dB[i] : dBValue);
+      }
+    }
+    std::memcpy(Out+Start, Resolve(Result, X, Y, Uniforms, Slots, Start), n*sizeof(double));
+    if(Result.Kind == Slot)
+    {
+      std::memcpy(OutX+Start, Tangents + 2*Result.Index*BlockSize, n*sizeof(double));
+      std::memcpy(OutY+Start, Tangents + (2*Result.Index+1)*BlockSize, n*sizeof(double));
+    }
+    else //The result is x or y itself.
+    {
+      std::fill(OutX+Start, OutX+Start+n, Result.Kind == ArrayX ? 1.0 : 0.0);
+      std::fill(OutY+Start, OutY+Start+n, Result.Kind == ArrayY ? 1.0 : 0.0);
+    }
+  }
+}
+
+void ExpressionObject::WeightedGradient(const double* X, const double* Y, const double* p, const double* Weights, double* Gradient, unsigned int N, double* Workspace) const
+{
+  //Gradient[k] = sum_i Weights[i]*df(X[i],Y[i])/dp_k, in forward mode: every step of the program also
+  //propagates the derivatives of its result with respect to the parameters it depends on. Only one block
+  //of derivatives is kept, so the memory does not grow with N.
+  unsigned int NUniforms(UniformSteps.size());
+  double* Uniforms(Workspace);
+  double* UniformTangents(Uniforms + NUniforms); //d(uniform u)/dp_k at u*NPar+k.
+  double* Slots(UniformTangents + NUniforms*NPar);
+  double* Tangents(Slots + NSlots*BlockSize); //d(slot s)/dp_k at (s*NPar+k)*BlockSize.
+  EvaluateUniforms(p, Uniforms);
+  for(unsigned int u(0); u < NUniforms; ++u)
+  {
+    const UniformStep& Step(UniformSteps[u]);
+    for(unsigned int k(0); k < NPar; ++k)
+    {
+      if(Step.Op == Constant) UniformTangents[u*NPar+k] = 0;
+      else if(Step.Op == Parameter) UniformTangents[u*NPar+k] = static_cast<unsigned int>(Step.Value) == k ? 1 : 0;
+      else UniformTangents[u*NPar+k] = Derivative(Step.Op, Uniforms[Step.Left], Uniforms[Step.Right], Uniforms[u], UniformTangents[Step.Left*NPar+k], UniformTangents[Step.Right*NPar+k]);
+    }
+  }
+  std::fill(Gradient, Gradient+NPar, 0.0);
+  if(Result.Kind == Uniform)
+  {
+    double SumWeights(0);
+    for(unsigned int i(0); i < N; ++i) SumWeights += Weights[i];
+    for(unsigned int k(0); k < NPar; ++k) Gradient[k] = SumWeights*UniformTangents[Result.Index*NPar+k];
+    return;
+  }
+  if(Result.Kind != Slot) return; //The result is x or y itself.
+
+  for(unsigned int Start(0); Start < N; Start += BlockSize)
+  {
+    unsigned int n(std::min(BlockSize, N-Start));
+    for(unsigned int s(0); s < VectorSteps.size(); ++s)
+    {
+      const VectorStep& Step(VectorSteps[s]);
+      Run(Step, X, Y, Uniforms, Slots, Start, n);
+      bool UniformA(Step.A.Kind == Uniform), UniformB(Step.B.Kind == Uniform);
+      const double* A(Resolve(Step.A, X, Y, Uniforms, Slots, Start));
+      const double* B(Resolve(Step.B, X, Y, Uniforms, Slots, Start));
+      const double* C(Slots + Step.Out*BlockSize);
+      bool Unary(Step.Op != Add && Step.Op != Subtract && Step.Op != Multiply && Step.Op != Divide && Step.Op != Power);
+      const std::vector<unsigned int>& Parameters(Dependencies[Step.Node]);
+      for(unsigned int d(0); d < Parameters.size(); ++d)
+      {
+	unsigned int k(Parameters[d]);
+	//Derivatives of the operands: an array for slots that depend on p_k, otherwise a single value.
+	const double* dA(nullptr);
+	const double* dB(nullptr);
+	double dAValue(0), dBValue(0);
+	if(Step.A.Kind == Slot && std::binary_search(Dependencies[Step.A.Node].begin(), Dependencies[Step.A.Node].end(), k)) dA = Tangents + (Step.A.Index*NPar+k)*BlockSize;
+	else if(UniformA) dAValue = UniformTangents[Step.A.Index*NPar+k];
+	if(!Unary && Step.B.Kind == Slot && std::binary_search(Dependencies[Step.B.Node].begin(), Dependencies[Step.B.Node].end(), k)) dB = Tangents + (Step.B.Index*NPar+k)*BlockSize;
+	else if(!Unary && UniformB) dBValue = UniformTangents[Step.B.Index*NPar+k];
+	double* dC(Tangents + (Step.Out*NPar+k)*BlockSize);
+	for(unsigned int i(0); i < n; ++i) dC[i] = Derivative(Step.Op, UniformA ? *A : A[i], Unary ? 0 : (UniformB ? *B : B[i]), C[i], dA ? dA[i] : dAValue, dB ? dB[i] : dBValue);
+      }
+    }
+    const std::vector<unsigned int>& Parameters(Dependencies[Result.Node]);
+    for(unsigned int d(0); d < Parameters.size(); ++d)
+    {
+      const double* dC(Tangents + (Result.Index*NPar+Parameters[d])*BlockSize);
+      double Sum(0);
+      for(unsigned int i(0); i < n; ++i) Sum += Weights[Start+i]*dC[i];
+      Gradient[Parameters[d]] += Sum;
+    }
+  }
+}
+
+double ExpressionObject::Evaluate(double X, double Y, const double* p) const
+{
+  return EvaluateNode(Root, X, Y, p);
+}
+
+double ExpressionObject::EvaluateNode(int Index, double X, double Y, const double* p) const
+{
+  const Node& Current(Nodes[Index]);
+  switch(Current.Op)
+  {
+  case Constant: return Current.Value;
+  case Parameter: return p[static_cast<unsigned int>(Current.Value)];
+  case VariableX: return X;
+  case VariableY: return Y;
+  default: return Apply(Current.Op, EvaluateNode(Current.Left, X, Y, p), Current.Right >= 0 ? EvaluateNode(Current.Right, X, Y, p) : 0);
+  }
+}
+
+unsigned int ExpressionObject::GetNPar() const
+{
+  return NPar;
+}
+
+unsigned int ExpressionObject::GetWorkspaceSize() const
+{
+  return UniformSteps.size() + NSlots*BlockSize;
+}
+
+unsigned int ExpressionObject::GetGradientWorkspaceSize() const
+{
+  return (UniformSteps.size() + NSlots*BlockSize)*(std::max(NPar, 2u)+1); //Also enough for EvaluateWithDerivatives.
+}
+
+bool ExpressionObject::UsesY() const
+{
+  return HasY;
+}
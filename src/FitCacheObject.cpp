@@ -0,0 +1,92 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads and writes the cache entries.
+#include <sstream> //Parses the cache entries.
+#include <iomanip> //Full precision output.
+#include <limits> //For std::numeric_limits.
+#include <cstdio> //For std::rename and std::remove.
+#include <stdexcept> //Thrown by std::stod on damaged entries.
+
+//POSIX includes.
+#include <sys/stat.h> //Creates the cache directory.
+#include <unistd.h> //For close.
+#include <stdlib.h> //For mkstemp.
+
+//Custom includes.
+#include "FitCacheObject.h" //Header file for this implementation.
+
+namespace
+{
+  bool ReadValues(std::istream& Input, const std::string& Name, std::vector<double>& Values)
+  {
+    //Line of the form Name:v0,v1,...
+    std::string Line, Item;
+    if(!std::getline(Input, Line) || Line.compare(0, Name.size()+1, Name + ":") != 0) return false;
+    std::stringstream Stream(Line.substr(Name.size()+1));
+    Values.clear();
+    while(std::getline(Stream, Item, ',')) Values.push_back(std::stod(Item));
+    return true;
+  }
+
+  void WriteValues(std::ostream& Output, const std::string& Name, const std::vector<double>& Values)
+  {
+    Output << Name << ":";
+    for(unsigned int i(0); i < Values.size(); ++i) Output << (i ? "," : "") << Values.at(i);
+    Output << std::endl;
+  }
+}
+
+FitCacheObject::FitCacheObject(std::string Directory, std::string Key)
+{
+  this->Directory = Directory;
+  FileName = Directory + "/Fit_" + Key + ".txt";
+}
+
+bool FitCacheObject::Load(double& Chisquare, double& EDM, unsigned int& NFree, std::vector<double>& Parameters, std::vector<double>& Errors, std::vector<double>& Covariance) const
+{
+  std::ifstream Input(FileName);
+  if(!Input.is_open()) return false;
+  std::vector<double> Summary, LoadedParameters, LoadedErrors, LoadedCovariance;
+  try
+  {
+    if(!ReadValues(Input, "Summary", Summary) || Summary.size() != 3) return false;
+    if(!ReadValues(Input, "Parameters", LoadedParameters) || !ReadValues(Input, "Errors", LoadedErrors) || !ReadValues(Input, "Covariance", LoadedCovariance)) return false;
+  }
+  catch(const std::exception&) { return false; } //Damaged entry, so the fit is simply run again.
+  if(LoadedErrors.size() != LoadedParameters.size() || LoadedCovariance.size() != LoadedParameters.size()*LoadedParameters.size()) return false;
+  Chisquare = Summary.at(0);
+  EDM = Summary.at(1);
+  NFree = Summary.at(2);
+  Parameters = LoadedParameters;
+  Errors = LoadedErrors;
+  Covariance = LoadedCovariance;
+  return true;
+}
+
+bool FitCacheObject::Save(double Chisquare, double EDM, unsigned int NFree, const std::vector<double>& Parameters, const std::vector<double>& Errors, const std::vector<double>& Covariance) const
+{
+  //Written under a temporary name and renamed, so that concurrent runs never read a partial entry. The name is
+  //unique to this call, as fits on several threads of one process may save the same entry.
+  mkdir(Directory.c_str(), 0755); //Fails harmlessly if it already exists.
+  std::string Temporary(FileName + ".XXXXXX");
+  int Descriptor(mkstemp(&Temporary[0]));
+  if(Descriptor < 0) return false;
+  fchmod(Descriptor, 0644); //As an entry written by std::ofstream, rather than mkstemp's 0600.
+  close(Descriptor);
+  std::ofstream Output(Temporary);
+  Output << std::setprecision(std::numeric_limits<double>::max_digits10);
+  WriteValues(Output, "Summary", std::vector<double>{Chisquare, EDM, static_cast<double>(NFree)});
+  WriteValues(Output, "Parameters", Parameters);
+  WriteValues(Output, "Errors", Errors);
+  WriteValues(Output, "Covariance", Covariance);
+  Output.close();
+  if(Output && std::rename(Temporary.c_str(), FileName.c_str()) == 0) return true;
+  std::remove(Temporary.c_str());
+  return false;
+}
+
+std::string FitCacheObject::GetFileName() const
+{
+  return FileName;
+}
@@ -0,0 +1,110 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads and writes the results.
+#include <sstream> //Number <-> string conversion.
+#include <iostream> //Basic input and output.
+#include <iomanip> //Full precision output.
+#include <limits> //For std::numeric_limits.
+#include <cstdio> //For std::rename and std::remove.
+#include <cstdlib> //For std::strtod.
+
+//POSIX includes.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "FitResultObject.h" //Header file for this implementation.
+
+FitResultObject::FitResultObject()
+{
+  Set("Format", "MinuitFit fit result 1");
+}
+
+bool FitResultObject::Load(std::string FileName)
+{
+  std::ifstream Input(FileName);
+  if(!Input.is_open())
+  {
+    std::cerr << "FitResultObject::Load(): Could not open " << FileName << "." << std::endl;
+    return false;
+  }
+  Entries.clear();
+  Keys.clear();
+  std::string Line;
+  while(std::getline(Input, Line))
+  {
+    std::size_t Colon(Line.find(":"));
+    if(Line.length() == 0 || Line[0] == '#' || Colon == std::string::npos) continue;
+    std::size_t First(Line.find("\"", Colon)), Last(Line.rfind("\""));
+    if(First == std::string::npos || Last == First) continue;
+    Set(Line.substr(0, Colon), Line.substr(First+1, Last-First-1));
+  }
+  if(Get("Format") != "MinuitFit fit result 1")
+  {
+    std::cerr << "FitResultObject::Load(): " << FileName << " is not a fit result this version can read." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool FitResultObject::Save(std::string FileName) const
+{
+  //Written under a temporary name and renamed, so that a reader never sees a partial file.
+  std::string Temporary(FileName + "." + std::to_string(getpid()));
+  std::ofstream Output(Temporary);
+  for(unsigned int k(0); k < Keys.size(); ++k) Output << Keys.at(k) << ":\"" << Entries.at(Keys.at(k)) << "\"" << std::endl;
+  Output.close();
+  if(Output && std::rename(Temporary.c_str(), FileName.c_str()) == 0) return true;
+  std::remove(Temporary.c_str());
+  return false;
+}
+
+void FitResultObject::Set(const std::string& Key, const std::string& Value)
+{
+  if(!Entries.count(Key)) Keys.push_back(Key);
+  Entries[Key] = Value;
+}
+
+void FitResultObject::Set(const std::string& Key, double Value)
+{
+  Set(Key, std::vector<double>(1, Value));
+}
+
+void FitResultObject::Set(const std::string& Key, const std::vector<double>& Values)
+{
+  std::stringstream Stream;
+  Stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for(unsigned int i(0); i < Values.size(); ++i) Stream << (i ? "," : "") << Values.at(i);
+  Set(Key, Stream.str());
+}
+
+bool FitResultObject::Has(const std::string& Key) const
+{
+  return Entries.count(Key) > 0;
+}
+
+std::string FitResultObject::Get(const std::string& Key) const
+{
+  std::map<std::string, std::string>::const_iterator Entry(Entries.find(Key));
+  return Entry == Entries.end() ? "" : Entry->second;
+}
+
+double FitResultObject::GetNumber(const std::string& Key) const
+{
+  std::vector<double> Values(GetNumbers(Key));
+  return Values.size() == 1 ? Values.at(0) : 0;
+}
+
+std::vector<double> FitResultObject::GetNumbers(const std::string& Key) const
+{
+  std::vector<double> Values;
+  std::stringstream Stream(Get(Key));
+  std::string Item;
+  while(std::getline(Stream, Item, ','))
+  {
+    char* End(nullptr);
+    Values.push_back(std::strtod(Item.c_str(), &End)); //Unlike std::stod, keeps subnormal values.
+    if(Item.empty() || *End != '\0') return std::vector<double>(); //Damaged value.
+  }
+  return Values;
+}
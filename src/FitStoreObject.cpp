@@ -0,0 +1,225 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads the store.
+#include <iostream> //Basic input and output.
+#include <algorithm> //For std::stable_sort.
+#include <cstring> //For std::memcpy.
+#include <ctime> //Time the records were appended.
+
+//POSIX includes.
+#include <fcntl.h> //Opens the files for appending.
+#include <unistd.h> //For write, lseek and close.
+#include <sys/file.h> //Locks the store while appending.
+#include <sys/stat.h> //Size of the index.
+
+//Custom includes.
+#include "FitStoreObject.h" //Header file for this implementation.
+
+namespace
+{
+  const char Magic[8] = "MFSTORE";
+  const std::size_t HeaderSize = 16;
+
+  bool WriteAll(int File, const char* Data, std::size_t Size)
+  {
+    while(Size > 0)
+    {
+      ssize_t Written(write(File, Data, Size));
+      if(Written <= 0) return false;
+      Data += Written;
+      Size -= Written;
+    }
+    return true;
+  }
+
+  template<typename T> void Put(char* Record, std::size_t Offset, T Value) { std::memcpy(Record + Offset, &Value, sizeof(T)); }
+
+  template<typename T> T Take(const char* Record, std::size_t Offset)
+  {
+    T Value;
+    std::memcpy(&Value, Record + Offset, sizeof(T));
+    return Value;
+  }
+}
+
+FitStoreObject::FitStoreObject(std::string Name)
+{
+  IndexName = Name + ".idx";
+  DataName = Name + ".dat";
+}
+
+bool FitStoreObject::Append(const Record& Entry) const
+{
+  unsigned int NPar(Entry.Parameters.size());
+  if(Entry.ModelType.size() >= ModelTypeSize || Entry.Errors.size() != NPar || Entry.Covariance.size() != NPar*NPar)
+  {
+    std::cerr << "FitStoreObject::Append(): Invalid record of " << Entry.ModelType << Entry.ModelID << "." << std::endl;
+    return false;
+  }
+  int Index(open(IndexName.c_str(), O_RDWR | O_CREAT, 0644));
+  if(Index < 0)
+  {
+    std::cerr << "FitStoreObject::Append(): Could not open " << IndexName << "." << std::endl;
+    return false;
+  }
+  //The lock on the index serializes the writers, so the arrays of a record are always written before its index
+  //entry, and the offsets of the index entries increase.
+  bool Success(flock(Index, LOCK_EX) == 0);
+  int Data(Success ? open(DataName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644) : -1);
+  struct stat Status;
+  Success = Data >= 0 && fstat(Index, &Status) == 0;
+  if(Success && Status.st_size == 0)
+  {
+    char Header[HeaderSize] = {};
+    std::memcpy(Header, Magic, sizeof(Magic));
+    Put<uint32_t>(Header, 8, Version);
+    Put<uint32_t>(Header, 12, RecordSize);
+    Success = WriteAll(Index, Header, HeaderSize);
+  }
+  else if(Success)
+  {
+    char Header[HeaderSize];
+    Success = pread(Index, Header, HeaderSize, 0) == static_cast<ssize_t>(HeaderSize) && std::memcmp(Header, Magic, sizeof(Magic)) == 0 && Take<uint32_t>(Header, 8) == Version && Take<uint32_t>(Header, 12) == RecordSize;
+    if(!Success) std::cerr << "FitStoreObject::Append(): " << IndexName << " is not a fit store of this version." << std::endl;
+    //Drops the partial entry of a writer that was interrupted.
+    else if((Status.st_size - HeaderSize) % RecordSize != 0) Success = ftruncate(Index, Status.st_size - (Status.st_size - HeaderSize) % RecordSize) == 0;
+  }
+  off_t Offset(Success ? lseek(Data, 0, SEEK_END) : -1);
+  Success = Offset >= 0;
+  if(Success) Success = WriteAll(Data, reinterpret_cast<const char*>(Entry.Parameters.data()), NPar*sizeof(double))
+		&& WriteAll(Data, reinterpret_cast<const char*>(Entry.Errors.data()), NPar*sizeof(double))
+		&& WriteAll(Data, reinterpret_cast<const char*>(Entry.Covariance.data()), NPar*NPar*sizeof(double));
+  if(Success)
+  {
+    char Entries[RecordSize] = {};
+    std::memcpy(Entries, Entry.ModelType.c_str(), Entry.ModelType.size());
+    Put<uint32_t>(Entries, 24, Entry.ModelID);
+    Put<uint32_t>(Entries, 28, NPar);
+    Put<uint64_t>(Entries, 32, Entry.FormulaHash);
+    Put<uint64_t>(Entries, 40, Entry.DataHash);
+    Put<double>(Entries, 48, Entry.Chisquare);
+    Put<double>(Entries, 56, Entry.EDM);
+    Put<int32_t>(Entries, 64, Entry.Status);
+    Put<uint32_t>(Entries, 68, Entry.NFree);
+    Put<uint32_t>(Entries, 72, Entry.NData);
+    Put<uint32_t>(Entries, 76, (Entry.Converged ? 1 : 0) | (Entry.FromCache ? 2 : 0));
+    Put<uint64_t>(Entries, 80, Entry.NCalls);
+    Put<double>(Entries, 88, Entry.FitTime);
+    Put<int64_t>(Entries, 96, std::time(nullptr));
+    Put<uint64_t>(Entries, 104, Offset);
+    Success = lseek(Index, 0, SEEK_END) >= 0 && WriteAll(Index, Entries, RecordSize);
+  }
+  if(!Success) std::cerr << "FitStoreObject::Append(): Could not append the fit of " << Entry.ModelType << Entry.ModelID << " to " << IndexName << "." << std::endl;
+  if(Data >= 0) close(Data);
+  close(Index); //Also releases the lock.
+  return Success;
+}
+
+bool FitStoreObject::Load()
+{
+  std::ifstream Input(IndexName, std::ios::binary);
+  std::vector<char> Buffer((std::istreambuf_iterator<char>(Input)), std::istreambuf_iterator<char>());
+  if(!Input.is_open() || Buffer.size() < HeaderSize || std::memcmp(Buffer.data(), Magic, sizeof(Magic)) != 0 || Take<uint32_t>(Buffer.data(), 8) != Version || Take<uint32_t>(Buffer.data(), 12) != RecordSize)
+  {
+    std::cerr << "FitStoreObject::Load(): " << IndexName << " is missing or not a fit store of this version." << std::endl;
+    return false;
+  }
+  std::size_t N((Buffer.size() - HeaderSize)/RecordSize);
+  ModelTypes.resize(N);
+  ModelIDs.resize(N);
+  NPars.resize(N);
+  FormulaHashes.resize(N);
+  DataHashes.resize(N);
+  Chisquares.resize(N);
+  EDMs.resize(N);
+  Statuses.resize(N);
+  NFrees.resize(N);
+  NDatas.resize(N);
+  Flags.resize(N);
+  NCalls.resize(N);
+  FitTimes.resize(N);
+  Times.resize(N);
+  Offsets.resize(N);
+  for(std::size_t i(0); i < N; ++i)
+  {
+    const char* Entry(Buffer.data() + HeaderSize + i*RecordSize);
+    ModelTypes[i].assign(Entry, strnlen(Entry, ModelTypeSize));
+    ModelIDs[i] = Take<uint32_t>(Entry, 24);
+    NPars[i] = Take<uint32_t>(Entry, 28);
+    FormulaHashes[i] = Take<uint64_t>(Entry, 32);
+    DataHashes[i] = Take<uint64_t>(Entry, 40);
+    Chisquares[i] = Take<double>(Entry, 48);
+    EDMs[i] = Take<double>(Entry, 56);
+    Statuses[i] = Take<int32_t>(Entry, 64);
+    NFrees[i] = Take<uint32_t>(Entry, 68);
+    NDatas[i] = Take<uint32_t>(Entry, 72);
+    Flags[i] = Take<uint32_t>(Entry, 76);
+    NCalls[i] = Take<uint64_t>(Entry, 80);
+    FitTimes[i] = Take<double>(Entry, 88);
+    Times[i] = Take<int64_t>(Entry, 96);
+    Offsets[i] = Take<uint64_t>(Entry, 104);
+  }
+  return true;
+}
+
+std::size_t FitStoreObject::GetNRecords() const
+{
+  return Offsets.size();
+}
+
+std::vector<std::size_t> FitStoreObject::Select(const std::function<bool(std::size_t Index)>& Filter) const
+{
+  std::vector<std::size_t> Indices;
+  for(std::size_t i(0); i < Offsets.size(); ++i) if(Filter(i)) Indices.push_back(i);
+  return Indices;
+}
+
+void FitStoreObject::Rank(std::vector<std::size_t>& Indices, const std::vector<double>& Column) const
+{
+  std::stable_sort(Indices.begin(), Indices.end(), [&](std::size_t a, std::size_t b) { return Column.at(a) < Column.at(b); });
+}
+
+bool FitStoreObject::GetArrays(std::size_t Index, std::vector<double>& Parameters, std::vector<double>& Errors, std::vector<double>& Covariance) const
+{
+  if(Index >= Offsets.size()) return false;
+  unsigned int NPar(NPars.at(Index));
+  Parameters.resize(NPar);
+  Errors.resize(NPar);
+  Covariance.resize(NPar*NPar);
+  std::ifstream Input(DataName, std::ios::binary);
+  Input.seekg(Offsets.at(Index));
+  Input.read(reinterpret_cast<char*>(Parameters.data()), NPar*sizeof(double));
+  Input.read(reinterpret_cast<char*>(Errors.data()), NPar*sizeof(double));
+  Input.read(reinterpret_cast<char*>(Covariance.data()), NPar*NPar*sizeof(double));
+  if(!Input) std::cerr << "FitStoreObject::GetArrays(): Could not read record " << Index << " from " << DataName << "." << std::endl;
+  return static_cast<bool>(Input);
+}
+
+const std::vector<std::string>& FitStoreObject::GetModelTypes() const { return ModelTypes; }
+
+const std::vector<unsigned int>& FitStoreObject::GetModelIDs() const { return ModelIDs; }
+
+const std::vector<unsigned int>& FitStoreObject::GetNPars() const { return NPars; }
+
+const std::vector<uint64_t>& FitStoreObject::GetFormulaHashes() const { return FormulaHashes; }
+
+const std::vector<uint64_t>& FitStoreObject::GetDataHashes() const { return DataHashes; }
+
+const std::vector<double>& FitStoreObject::GetChisquares() const { return Chisquares; }
+
+const std::vector<double>& FitStoreObject::GetEDMs() const { return EDMs; }
+
+const std::vector<int>& FitStoreObject::GetStatuses() const { return Statuses; }
+
+const std::vector<unsigned int>& FitStoreObject::GetNFrees() const { return NFrees; }
+
+const std::vector<unsigned int>& FitStoreObject::GetNDatas() const { return NDatas; }
+
+const std::vector<unsigned int>& FitStoreObject::GetFlags() const { return Flags; }
+
+const std::vector<unsigned long>& FitStoreObject::GetNCalls() const { return NCalls; }
+
+const std::vector<double>& FitStoreObject::GetFitTimes() const { return FitTimes; }
+
+const std::vector<int64_t>& FitStoreObject::GetTimes() const { return Times; }
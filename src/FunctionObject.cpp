@@ -3,156 +3,95 @@
 #include <string>
 #include <fstream>
 #include <sstream>
-#include <cctype>
-#include <map>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
 
 //ROOT includes.
 
 //Custom includes.
 #include "FunctionObject.h"
+#include "DefinitionsObject.h" //Definitions file, parsed once per process.
 
-FunctionObject::FunctionObject(std::string Definitions, std::string SearchString, unsigned int ModelID, bool& Success)
+namespace
 {
-  std::ifstream Input(Definitions);
-  std::string Line, FunctionString, ParameterString, LimitLowString, LimitHighString, StepSizesString, Tmp, ModelIDString, SetsString, RecipesString;
-  std::size_t First, Last;
-  bool Found(false);
-
-  if(Input.is_open())
+  std::vector<std::string> Split(const std::string& List)
   {
-    while(std::getline(Input, Line))
+    std::vector<std::string> Items;
+    std::string Tmp;
+    for(unsigned int i(0); i < List.length(); ++i)
     {
-      if(Line[0] != '#')
+      if(List[i] != ',') Tmp += List[i];
+      else
       {
-	if(Line.find(SearchString+std::string("F")+std::to_string(ModelID)) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"",First+1);
-	  FunctionString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("F")+std::to_string(ModelID), FunctionString);
-	}
-	else if(Line.find(SearchString+std::string("P")+std::to_string(ModelID)) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"",First+1);
-	  ParameterString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("P")+std::to_string(ModelID), ParameterString);
-	}
-	else if(Line.find(SearchString+std::string("LL")+std::to_string(ModelID)) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"",First+1);
-	  LimitLowString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("LL")+std::to_string(ModelID), LimitLowString);
-	}
-	else if(Line.find(SearchString+std::string("LH")+std::to_string(ModelID)) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"",First+1);
-	  LimitHighString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("LH")+std::to_string(ModelID), LimitHighString);
-	}
-	else if(Line.find(SearchString+std::string("S")+std::to_string(ModelID)) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"",First+1);
-	  StepSizesString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("S")+std::to_string(ModelID), StepSizesString);
-	}
-	else if(Line.find(SearchString+std::string("Sets")) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"", First+1);
-	  SetsString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("Sets"), SetsString);
-	}
-	else if(Line.find(SearchString+std::string("Recipes")) !=std::string::npos)
-	{
-	  First = Line.find("\"");
-	  Last = Line.find("\"", First+1);
-	  RecipesString = Line.substr(First+1,Last-First-1);
-	  DefinitionsMap.emplace(SearchString+std::string("Recipes"), RecipesString);
-	}
-	Found = (FunctionString != "" && ParameterString != "" && LimitLowString != "", LimitHighString != "" && StepSizesString != "");	
+	Items.push_back(Tmp);
+	Tmp = "";
       }
     }
+    if(Tmp != "") Items.push_back(Tmp);
+    return Items;
   }
 
-  //for(unsigned int i(0); i < Line.size(); ++i) if(std::isdigit(Line[i])) ModelIDString += Line[i];
-  //if(ModelIDString != "")
-  
-  if(Found)
+  bool ToNumbers(const std::vector<std::string>& Items, std::vector<double>& Numbers)
   {
-    Function = FunctionString;
-    for(unsigned int i(0); i < ParameterString.length(); ++i)
-    {
-      if(ParameterString[i] != ',') Tmp += ParameterString[i];
-      else
-      {
-	Parameters.push_back(std::stod(Tmp));
-	Tmp = "";
-      }
-    }
-    if(Tmp != "") Parameters.push_back(std::stod(Tmp));
-    Tmp = "";
-    for(unsigned int i(0); i < LimitLowString.length(); ++i)
-    {
-      if(LimitLowString[i] != ',') Tmp += LimitLowString[i];
-      else
-      {
-	LimitsLow.push_back(std::stod(Tmp));
-	Tmp = "";
-      }
-    }
-    if(Tmp != "") LimitsLow.push_back(std::stod(Tmp));
-    Tmp = "";
-    for(unsigned int i(0); i < LimitHighString.length(); ++i)
-    {
-      if(LimitHighString[i] != ',') Tmp += LimitHighString[i];
-      else
-      {
-	LimitsHigh.push_back(std::stod(Tmp));
-	Tmp = "";
-      }
-    }
-    if(Tmp != "") LimitsHigh.push_back(std::stod(Tmp));
-    Tmp = "";
-    for(unsigned int i(0); i < StepSizesString.length(); ++i)
-    {
-      if(StepSizesString[i] != ',') Tmp += StepSizesString[i];
-      else
-      {
-	StepSizes.push_back(std::stod(Tmp));
-	Tmp = "";
-      }
-    }
-    if(Tmp != "") StepSizes.push_back(std::stod(Tmp));
-    Tmp = "";
-    for(unsigned int i(0); i < SetsString.length(); ++i)
-    {
-      if(SetsString[i] != ',') Tmp += SetsString[i];
-      else
-      {
-	Sets.push_back(Tmp);
-	Tmp = "";
-      }
-    }
-    if(Tmp != "") Sets.push_back(Tmp);
-    Tmp = "";
-    for(unsigned int i(0); i < RecipesString.length(); ++i)
-    {
-      if(RecipesString[i] != ',') Tmp += RecipesString[i];
-      else
-      {
-	Recipes.push_back(Tmp);
-	Tmp = "";
-      }
-    }
-    if(Tmp != "") Recipes.push_back(Tmp);
-    Success = true;
+    try { for(unsigned int i(0); i < Items.size(); ++i) Numbers.push_back(std::stod(Items.at(i))); }
+    catch(const std::exception&) { return false; }
+    return true;
   }
-  else Success = false;
 }
+
+FunctionObject::FunctionObject(std::string Definitions, std::string SearchString, unsigned int ModelID, bool& Success)
+{
+  std::shared_ptr<const DefinitionsObject> Registry(DefinitionsObject::Get(Definitions));
+  std::string FunctionString, ParameterString, LimitLowString, LimitHighString, StepSizesString, SetsString, RecipesString;
+  std::string Name(SearchString + std::to_string(ModelID));
+
+  Success = Registry->Find(SearchString, "F", ModelID, FunctionString) && Registry->Find(SearchString, "P", ModelID, ParameterString) && Registry->Find(SearchString, "LL", ModelID, LimitLowString) && Registry->Find(SearchString, "LH", ModelID, LimitHighString) && Registry->Find(SearchString, "S", ModelID, StepSizesString);
+  if(!Success) return;
+  Registry->Find(SearchString + "Sets", SetsString); //Shared by every ID of a ModelType, and optional for recipe models.
+  Registry->Find(SearchString + "Recipes", RecipesString);
+
+  Function = FunctionString;
+  Sets = Split(SetsString);
+  Recipes = Split(RecipesString);
+  if(!ToNumbers(Split(ParameterString), Parameters) || !ToNumbers(Split(LimitLowString), LimitsLow) || !ToNumbers(Split(LimitHighString), LimitsHigh) || !ToNumbers(Split(StepSizesString), StepSizes))
+  {
+    std::cerr << "FunctionObject::FunctionObject(): " << Name << " has a value that is not a number." << std::endl;
+    Success = false;
+  }
+  else if(LimitsLow.size() != Parameters.size() || LimitsHigh.size() != Parameters.size() || StepSizes.size() != Parameters.size())
+  {
+    std::cerr << "FunctionObject::FunctionObject(): " << Name << " has " << Parameters.size() << " parameters, but " << LimitsLow.size() << " lower limits, " << LimitsHigh.size() << " upper limits and " << StepSizes.size() << " step sizes." << std::endl;
+    Success = false;
+  }
+  else if(!Recipes.empty() && Recipes.size() != Sets.size())
+  {
+    std::cerr << "FunctionObject::FunctionObject(): " << SearchString << " has " << Sets.size() << " sets, but " << Recipes.size() << " recipes." << std::endl;
+    Success = false;
+  }
+  else if(CountParameters(Function) > Parameters.size()) //The model function would read past the parameters.
+  {
+    std::cerr << "FunctionObject::FunctionObject(): The function of " << Name << " uses " << CountParameters(Function) << " parameters, but only " << Parameters.size() << " are defined." << std::endl;
+    Success = false;
+  }
+}
+
+unsigned int FunctionObject::CountParameters(const std::string& Formula)
+{
+  //One more than the highest [n] in the formula.
+  unsigned int Count(0);
+  std::size_t Open(Formula.find('['));
+  while(Open != std::string::npos)
+  {
+    std::size_t Close(Formula.find(']', Open));
+    std::string Index(Close == std::string::npos ? "" : Formula.substr(Open+1, Close-Open-1));
+    if(!Index.empty() && Index.find_first_not_of("0123456789") == std::string::npos) Count = std::max(Count, static_cast<unsigned int>(std::stoul(Index))+1);
+    Open = Formula.find('[', Open+1);
+  }
+  return Count;
+}
+
 std::string FunctionObject::GetFunction()
 {
   return Function;
@@ -187,3 +126,8 @@ std::vector<std::string> FunctionObject::GetRecipes()
 {
   return Recipes;
 }
+
+std::vector<unsigned int> FunctionObject::FindModelIDs(std::string Definitions, std::string SearchString)
+{
+  return DefinitionsObject::Get(Definitions)->FindModelIDs(SearchString);
+}
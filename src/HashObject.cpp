@@ -0,0 +1,64 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Reads the files being hashed.
+#include <sstream> //Formats the hash.
+#include <iomanip> //Formats the hash.
+
+//Custom includes.
+#include "HashObject.h" //Header file for this implementation.
+
+HashObject::HashObject()
+{
+  Value = 14695981039346656037ULL;
+}
+
+void HashObject::Add(const char* Data, std::size_t Size)
+{
+  for(std::size_t i(0); i < Size; ++i)
+  {
+    Value ^= static_cast<unsigned char>(Data[i]);
+    Value *= 1099511628211ULL;
+  }
+}
+
+void HashObject::Add(const std::string& Text)
+{
+  //The length goes first, so that the pieces can't run into each other ("ab"+"c" differs from "a"+"bc").
+  uint64_t Size(Text.size());
+  Add(reinterpret_cast<const char*>(&Size), sizeof(Size));
+  Add(Text.data(), Text.size());
+}
+
+void HashObject::Add(const std::vector<double>& Values)
+{
+  uint64_t Size(Values.size());
+  Add(reinterpret_cast<const char*>(&Size), sizeof(Size));
+  Add(reinterpret_cast<const char*>(Values.data()), Values.size()*sizeof(double)); //Exact bits, unlike a printed value.
+}
+
+bool HashObject::AddFile(const std::string& FileName)
+{
+  std::ifstream Input(FileName, std::ios::binary);
+  if(!Input.is_open())
+  {
+    Add(std::string()); //Missing files still change the hash.
+    return false;
+  }
+  std::stringstream Contents;
+  Contents << Input.rdbuf();
+  Add(Contents.str());
+  return true;
+}
+
+uint64_t HashObject::Get() const
+{
+  return Value;
+}
+
+std::string HashObject::GetHex() const
+{
+  std::stringstream Hex;
+  Hex << std::hex << std::setw(16) << std::setfill('0') << Value;
+  return Hex.str();
+}
@@ -1,25 +1,117 @@
 //C++ includes.
 #include <string> //Basic string.
 #include <iostream> //Basic input and output.
+#include <limits> //For std::numeric_limits.
+#include <stdexcept> //Thrown by std::stoul on out of range numbers.
+
+//ROOT includes.
+#include "TROOT.h" //For enabling thread safety.
 
 //Custom includes.
 #include "Models.h" //Header file for the model objects.
+#include "ModelSweep.h" //Fits every model of a ModelType in one process.
+#include "ModelResampling.h" //Bootstrap and jackknife errors of a model.
+#include "ModelScan.h" //Chi-square of a model over a grid of its parameters.
+#include "ModelChain.h" //Fits the recipes of a model before it.
+
+namespace
+{
+  void PrintUsage()
+  {
+    std::cerr << "Invalid arguments. First argument must be the model type (as listed in function definitions file; e.g. \"NRQY\"). Second argument must be a valid model ID. Example: \'./MinuitFit NRQY 0\'. Use \'all\' as the model ID to fit every model of the type, optionally followed by \'-j N\' to use N threads. Add \'bootstrap\' or \'jackknife\' after the model ID (optionally followed by \'-j N\') to estimate the errors by refitting resampled data, \'scan\' to evaluate the chi-square over a grid of parameters, or \'chain\' to first fit the models its recipes use. Use \'rank\' as the model ID to rank the fits of the type in the fit store." << std::endl;
+  }
+
+  //Reads the N of '-j N'. False, rather than an exception, if it isn't a non-negative integer.
+  bool ReadThreads(const std::string& Text, unsigned int& NThreads)
+  {
+    if(Text.empty() || Text.find_first_not_of("0123456789") != std::string::npos) return false;
+    try
+    {
+      unsigned long Value(std::stoul(Text));
+      if(Value > std::numeric_limits<unsigned int>::max()) return false;
+      NThreads = Value;
+    }
+    catch(const std::out_of_range&)
+    {
+      return false;
+    }
+    return true;
+  }
+}
 
 int main(int argc, char** argv)
 {
-  if(argc == 3)
+  if((argc == 3 || argc == 5) && std::string(argv[2]) == "all")
+  {
+    ROOT::EnableThreadSafety(); //Models own their minimizer and functions, so they may be fit concurrently.
+    unsigned int NThreads(0); //Zero uses every core.
+    if(argc == 5 && std::string(argv[3]) == "-j")
+    {
+      if(!ReadThreads(argv[4], NThreads))
+      {
+	PrintUsage();
+	return 0;
+      }
+    }
+    else if(argc == 5)
+    {
+      std::cerr << "Invalid arguments. The only option accepted after \'all\' is \'-j N\'." << std::endl;
+      return 0;
+    }
+    NESTModel::ModelSweep Sweep(argv[1], NThreads);
+    Sweep.Run();
+  }
+  else if((argc == 4 || argc == 6) && (std::string(argv[3]) == "bootstrap" || std::string(argv[3]) == "jackknife" || std::string(argv[3]) == "scan" || std::string(argv[3]) == "chain"))
+  {
+    ROOT::EnableThreadSafety(); //Each replica (or scan worker) owns its model, so they may be fit concurrently.
+    unsigned int NThreads(0); //Zero uses every core.
+    if(argc == 6 && std::string(argv[4]) == "-j")
+    {
+      if(!ReadThreads(argv[5], NThreads))
+      {
+	PrintUsage();
+	return 0;
+      }
+    }
+    else if(argc == 6)
+    {
+      std::cerr << "Invalid arguments. The only option accepted after \'" << argv[3] << "\' is \'-j N\'." << std::endl;
+      return 0;
+    }
+    if(std::string(argv[3]) == "chain")
+    {
+      NESTModel::ModelChain Chain(argv[1], std::stoi(argv[2]), NThreads);
+      Chain.Run();
+    }
+    else if(std::string(argv[3]) == "scan")
+    {
+      NESTModel::ModelScan Scan(argv[1], std::stoi(argv[2]), NThreads);
+      Scan.Run();
+    }
+    else
+    {
+      NESTModel::ModelResampling Resampling(argv[1], std::stoi(argv[2]), std::string(argv[3]) == "bootstrap" ? NESTModel::ModelResampling::Bootstrap : NESTModel::ModelResampling::Jackknife, NThreads);
+      Resampling.Run();
+    }
+  }
+  else if(argc == 3 && std::string(argv[2]) == "rank")
+  {
+    if(!NESTModel::ModelSweep::PrintStoreRanking(argv[1], std::cout)) std::cerr << "There is no fit store to rank. Set \'FitStore\' in the settings file and fit the models first." << std::endl;
+  }
+  else if(argc == 3)
   {
+    ROOT::EnableThreadSafety(); //Models own their minimizer and functions, so they may be fit concurrently.
     std::string ModelType;
     unsigned int ModelArg(0);
     ModelType = argv[1];
     ModelArg = std::stoi(argv[2]);
     NESTModel::BasicModel Model(ModelType,ModelArg);
-    NESTModel::GlobalModel = &Model;
     Model.Minimize();
     Model.PrintResults();
     Model.SaveParameters();
-    Model.DrawGraphs();
+    if(Model.GetSettings()->Query("PlotAfterFit") == "true") Model.DrawGraphs();
+    if(Model.IsConverged()) Model.SaveContours();
   }
-  else std::cerr << "Invalid arguments. First argument must be the model type (as listed in function definitions file; e.g. \"NRQY\"). Second argument must be a valid model ID. Example: \'./MinuitFit NRQY 0\'" << std::endl;
+  else PrintUsage();
   return 0;
 }
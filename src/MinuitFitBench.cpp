@@ -0,0 +1,291 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <iostream> //Basic input and output.
+#include <fstream> //Writes the data sets and the results.
+#include <sstream> //Useful for number -> string conversion.
+#include <iomanip> //Full precision output.
+#include <chrono> //Times the calls.
+#include <random> //Generates the data sets.
+#include <functional> //Bodies of the benchmarks.
+#include <cstdio> //For std::remove.
+#include <ctime> //Date of the run.
+#include <limits> //For std::numeric_limits.
+
+//POSIX includes.
+#include <unistd.h> //For rmdir.
+
+//ROOT includes.
+#include "RVersion.h" //Version of ROOT the results were measured with.
+#include "TMatrixT.h" //Covariance of the recipe parameters.
+
+//Custom includes.
+#include "Models.h" //Header file for the model objects.
+#include "DataObject.h" //Modularizes the input of data sets from .txt files.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "FunctionObject.h" //Initial parameters of the models.
+#include "CovarianceObject.h" //Factorized covariance for evaluating the chi-square.
+#include "DataCacheObject.h" //Number of columns of a data set.
+#include "AllocationCounter.h" //Counts the allocations of the calls.
+
+//Times the hot paths of a fit over data sets of 10^2 to 10^6 points and models of increasing complexity, and
+//writes the results as JSON, so that runs on different commits or ROOT versions can be compared:
+//  ./MinuitFitBench [-o MinuitFitBench.json] [-n MaxPoints] [-t MinSeconds] [-m NRQY0,ERQY7]
+//Run it where MinuitFit runs: the settings and definitions are read from Settings.txt. Each data size has two
+//generated data sets of half the points, the second one converted by the NRTY0 recipe, so the covariance has
+//a diagonal and a low rank block like the real data. Every call of a benchmark is repeated until MinSeconds
+//have passed, and every allocation of the process (including those of ROOT and of the worker threads) is counted
+//by the operator new of AllocationCounter.
+
+namespace
+{
+  volatile double Sink; //Keeps the results of the calls from being optimized away.
+
+  struct Measurement
+  {
+    std::string Name;
+    std::string Model; //Empty for the benchmarks of the data.
+    unsigned long NPoints;
+    unsigned long Calls;
+    double Seconds;
+    unsigned long Allocations;
+    double ItemsPerCall; //Points (or rows) handled by one call.
+  };
+
+  Measurement Time(const std::string& Name, const std::string& Model, unsigned long NPoints, double ItemsPerCall, double MinSeconds, const std::function<void()>& Body)
+  {
+    //The number of calls is doubled until they take MinSeconds, and only the last round is kept.
+    Body(); //Warms up the caches and any lazily built state.
+    Measurement Result{Name, Model, NPoints, 1, 0, 0, ItemsPerCall};
+    while(true)
+    {
+      unsigned long Before(GetNAllocations());
+      std::chrono::steady_clock::time_point Start(std::chrono::steady_clock::now());
+      for(unsigned long c(0); c < Result.Calls; ++c) Body();
+      Result.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+      Result.Allocations = GetNAllocations() - Before;
+      if(Result.Seconds >= MinSeconds || Result.Calls >= (1ul << 30)) break;
+      Result.Calls *= 2;
+    }
+    std::cerr << "MinuitFitBench: " << Name << (Model.empty() ? "" : " " + Model) << ", " << NPoints << " points: "
+	      << 1e9*Result.Seconds/Result.Calls << " ns per call." << std::endl;
+    return Result;
+  }
+
+  //Columns x, its errors, y, its errors, z, its errors, in the ranges of the real data.
+  std::vector< std::vector<double> > Generate(unsigned long NRows, unsigned int Seed)
+  {
+    std::mt19937_64 Engine(Seed);
+    std::uniform_real_distribution<double> Energy(1, 100), Field(10, 1000), Yield(1, 50);
+    std::vector< std::vector<double> > Columns(DataCacheObject::NColumns, std::vector<double>(NRows));
+    for(unsigned long i(0); i < NRows; ++i)
+    {
+      Columns[0][i] = Energy(Engine);
+      Columns[1][i] = Columns[2][i] = 0.05*Columns[0][i];
+      Columns[3][i] = Field(Engine);
+      Columns[4][i] = Columns[5][i] = 0.02*Columns[3][i];
+      Columns[6][i] = Yield(Engine);
+      Columns[7][i] = Columns[8][i] = 0.05*Columns[6][i];
+    }
+    return Columns;
+  }
+
+  bool WriteCSV(const std::string& FileName, const std::vector< std::vector<double> >& Columns)
+  {
+    std::ofstream Output(FileName);
+    Output << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for(unsigned long i(0); i < Columns.at(0).size(); ++i)
+    {
+      for(unsigned int c(0); c < Columns.size(); ++c) Output << (c ? "," : "") << Columns[c][i];
+      Output << "\n";
+    }
+    Output.close();
+    return static_cast<bool>(Output);
+  }
+
+  std::string Escape(const std::string& Text)
+  {
+    std::string Escaped;
+    for(char Character : Text)
+    {
+      if(Character == '"' || Character == '\\') Escaped += '\\';
+      if(static_cast<unsigned char>(Character) >= 0x20) Escaped += Character;
+    }
+    return Escaped;
+  }
+}
+
+//Calls the private steps of loading the data.
+struct DataObjectBench
+{
+  static int ReadData(DataObject& Data, const std::string& FileName, std::vector<double>& List) { return Data.ReadData(FileName, List, DataCacheObject::NColumns); }
+  static CovarianceBlock BuildCovariance(DataObject& Data, const std::vector< std::vector<double> >& Columns, const TMatrixT<double>& V_P) { return Data.BuildCovariance(Columns, V_P); }
+};
+
+int main(int argc, char** argv)
+{
+  std::string OutputName("MinuitFitBench.json"), ModelList("NRTY0,NRQY0,NRLY0,ERQY1,ERQY7");
+  unsigned long MaxPoints(1000000);
+  double MinSeconds(0.2);
+  for(int i(1); i+1 < argc; i+=2)
+  {
+    std::string Option(argv[i]);
+    if(Option == "-o") OutputName = argv[i+1];
+    else if(Option == "-n") MaxPoints = std::stoul(argv[i+1]);
+    else if(Option == "-t") MinSeconds = std::stod(argv[i+1]);
+    else if(Option == "-m") ModelList = argv[i+1];
+    else
+    {
+      std::cerr << "Invalid arguments. Usage: \'./MinuitFitBench [-o MinuitFitBench.json] [-n MaxPoints] [-t MinSeconds] [-m NRQY0,ERQY7]\'." << std::endl;
+      return 1;
+    }
+  }
+  if(argc % 2 == 0)
+  {
+    std::cerr << "Invalid arguments. Every option needs a value." << std::endl;
+    return 1;
+  }
+
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  std::vector< std::pair<std::string, unsigned int> > Models; //Type and ID, e.g. NRQY0 is ("NRQY", 0).
+  std::stringstream List(ModelList);
+  std::string Model;
+  while(std::getline(List, Model, ','))
+  {
+    std::size_t Digits(Model.find_first_of("0123456789"));
+    if(Digits == 0 || Digits == std::string::npos) std::cerr << "MinuitFitBench: " << Model << " is not a ModelType followed by a ModelID." << std::endl;
+    else Models.push_back(std::make_pair(Model.substr(0, Digits), std::stoi(Model.substr(Digits))));
+  }
+
+  char Directory[] = "/tmp/MinuitFitBench.XXXXXX";
+  if(!mkdtemp(Directory))
+  {
+    std::cerr << "MinuitFitBench: Could not create a directory for the data sets." << std::endl;
+    return 1;
+  }
+  std::vector<Measurement> Results;
+  std::vector<std::string> Skipped;
+  std::map<std::string, RecipeResult> Recipes;
+  Recipes["NRTY0"].Parameters = {10, 0.01}; //NRTYP0, with 10% uncertainties.
+  Recipes["NRTY0"].Covariance = {1, 0, 0, 1e-6};
+  TMatrixT<double> RecipeCovariance(2, 2);
+  RecipeCovariance(0, 0) = 1;
+  RecipeCovariance(1, 1) = 1e-6;
+
+  for(unsigned long NPoints(100); NPoints <= MaxPoints; NPoints *= 10)
+  {
+    std::string Plain(std::string(Directory) + "/Plain" + std::to_string(NPoints)), Converted(std::string(Directory) + "/Recipe" + std::to_string(NPoints));
+    std::vector< std::vector<double> > PlainColumns(Generate(NPoints/2, 1)), RecipeColumns(Generate(NPoints - NPoints/2, 2));
+    if(!WriteCSV(Plain + ".csv", PlainColumns) || !WriteCSV(Converted + ".csv", RecipeColumns))
+    {
+      std::cerr << "MinuitFitBench: Could not write the data sets to " << Directory << "." << std::endl;
+      break;
+    }
+    std::shared_ptr<DataObject> Data(new DataObject({Plain, Converted}, {".", "NRTY0"}, std::stod(Settings->Query("DefaultYieldUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("LowField")), Settings->Query("FunctionDefinitions"), Settings->Query("CompileFormulas") == "true" ? Settings->Query("FormulaCache") : "", Settings->Query("FormulaCompiler"), Recipes)); //As BasicModel::LoadData() loads it.
+    if(!Data->IsValid())
+    {
+      std::cerr << "MinuitFitBench: The generated data of " << NPoints << " points is not valid." << std::endl;
+      break;
+    }
+
+    std::vector<double> Rows;
+    Results.push_back(Time("ReadData", "", NPoints, NPoints, MinSeconds, [&]() {
+	  DataObjectBench::ReadData(*Data, Plain + ".csv", Rows);
+	  DataObjectBench::ReadData(*Data, Converted + ".csv", Rows);
+	}));
+    Results.push_back(Time("BuildCovariance", "", NPoints, RecipeColumns.at(0).size(), MinSeconds, [&]() {
+	  DataObjectBench::BuildCovariance(*Data, RecipeColumns, RecipeCovariance);
+	}));
+    Results.push_back(Time("CovarianceFactorization", "", NPoints, NPoints, MinSeconds, [&]() {
+	  bool Factorized(false);
+	  CovarianceObject Factor(Data->GetCovarianceBlocks(), Factorized);
+	}));
+
+    for(unsigned int m(0); m < Models.size(); ++m)
+    {
+      std::string Name(Models.at(m).first + std::to_string(Models.at(m).second));
+      bool Defined(false);
+      FunctionObject Definition(Settings->Query("FunctionDefinitions"), Models.at(m).first, Models.at(m).second, Defined);
+      NESTModel::BasicModel Fit(Models.at(m).first, Models.at(m).second, Settings, Data);
+      if(!Defined || !Fit.IsDefined())
+      {
+	if(NPoints == 100) Skipped.push_back(Name);
+	continue;
+      }
+      std::vector<double> p(Definition.GetParameters());
+      const std::vector<double>& X(Fit.GetDataX());
+      const std::vector<double>& Y(Fit.GetDataY());
+      double Sum(0);
+      Results.push_back(Time("operator()", Name, NPoints, NPoints, MinSeconds, [&]() {
+	    for(unsigned long i(0); i < X.size(); ++i)
+	    {
+	      double x[2] = {X[i], Y[i]};
+	      Sum += Fit(x, p.data());
+	    }
+	  }));
+      Results.push_back(Time("DerivativeX", Name, NPoints, NPoints, MinSeconds, [&]() {
+	    for(unsigned long i(0); i < X.size(); ++i)
+	    {
+	      double x[2] = {X[i], Y[i]};
+	      Sum += Fit.DerivativeX(x, p.data());
+	    }
+	  }));
+      Results.push_back(Time("DerivativeY", Name, NPoints, NPoints, MinSeconds, [&]() {
+	    for(unsigned long i(0); i < X.size(); ++i)
+	    {
+	      double x[2] = {X[i], Y[i]};
+	      Sum += Fit.DerivativeY(x, p.data());
+	    }
+	  }));
+      Results.push_back(Time("Chi2", Name, NPoints, NPoints, MinSeconds, [&]() { Sum += Fit.Chi2(p.data()); }));
+      Results.push_back(Time("Chi2Covariance", Name, NPoints, NPoints, MinSeconds, [&]() { Sum += Fit.Chi2Covariance(p.data()); }));
+      Sink = Sum;
+    }
+    std::remove((Plain + ".csv").c_str());
+    std::remove((Converted + ".csv").c_str());
+  }
+  rmdir(Directory);
+
+  std::ofstream Output(OutputName);
+  std::time_t Now(std::time(nullptr));
+  char Date[32];
+  std::strftime(Date, sizeof(Date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&Now));
+  Output << std::setprecision(6);
+  Output << "{\n"
+	 << "  \"benchmark\": \"MinuitFitBench\",\n"
+	 << "  \"format\": 1,\n"
+	 << "  \"date\": \"" << Date << "\",\n"
+	 << "  \"root\": \"" << ROOT_RELEASE << "\",\n"
+	 << "  \"compiler\": \"" << Escape(__VERSION__) << "\",\n"
+	 << "  \"min_seconds\": " << MinSeconds << ",\n"
+	 << "  \"settings\": {";
+  const char* Keys[] = {"FitThreads", "CompileFormulas", "Chi2"};
+  for(unsigned int k(0); k < sizeof(Keys)/sizeof(Keys[0]); ++k) Output << (k ? ", " : "") << "\"" << Keys[k] << "\": \"" << Escape(Settings->Query(Keys[k])) << "\"";
+  Output << "},\n"
+	 << "  \"skipped\": [";
+  for(unsigned int s(0); s < Skipped.size(); ++s) Output << (s ? ", " : "") << "\"" << Escape(Skipped.at(s)) << "\"";
+  Output << "],\n"
+	 << "  \"results\": [\n";
+  for(unsigned int r(0); r < Results.size(); ++r)
+  {
+    const Measurement& Result(Results.at(r));
+    Output << "    {\"name\": \"" << Result.Name << "\", \"model\": \"" << Escape(Result.Model) << "\", \"points\": " << Result.NPoints
+	   << ", \"calls\": " << Result.Calls << ", \"seconds\": " << Result.Seconds
+	   << ", \"ns_per_call\": " << 1e9*Result.Seconds/Result.Calls
+	   << ", \"allocations_per_call\": " << static_cast<double>(Result.Allocations)/Result.Calls
+	   << ", \"items_per_second\": " << Result.ItemsPerCall*Result.Calls/Result.Seconds << "}"
+	   << (r+1 < Results.size() ? "," : "") << "\n";
+  }
+  Output << "  ]\n"
+	 << "}\n";
+  Output.close();
+  if(!Output)
+  {
+    std::cerr << "MinuitFitBench: Could not write " << OutputName << "." << std::endl;
+    return 1;
+  }
+  std::cerr << "MinuitFitBench: Wrote " << Results.size() << " results to " << OutputName << "." << std::endl;
+  return 0;
+}
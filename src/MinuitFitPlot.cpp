@@ -0,0 +1,95 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <iostream> //Basic input and output.
+#include <cstdio> //For std::sscanf.
+
+//ROOT includes.
+#include "TROOT.h" //Batch mode.
+
+//Custom includes.
+#include "Models.h" //Header file for the model objects.
+#include "DataObject.h" //Data sets of the fits.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "FitResultObject.h" //Fit results written by MinuitFit.
+
+namespace
+{
+  std::vector<std::string> Split(const std::string& List)
+  {
+    std::vector<std::string> Items;
+    std::size_t Start(0);
+    while(Start < List.size())
+    {
+      std::size_t End(List.find(',', Start));
+      if(End == std::string::npos) End = List.size();
+      Items.push_back(List.substr(Start, End-Start));
+      Start = End+1;
+    }
+    return Items;
+  }
+}
+
+//Draws the plots of fits made earlier by MinuitFit (with "FitResults" set), from their <ModelType><ModelID>Fit.txt
+//files, without fitting again. The model is built from what the file records: its definitions file, data sets,
+//recipes and default uncertainties. Plot settings are read from Settings.txt. A fit whose data changed since
+//(by the hash of the data sets and recipe inputs) is not drawn, unless -f is given. With -b <First>-<Last>, only
+//the images of those field bins are saved, as a plotting worker of BasicModel::DrawGraphs().
+int main(int argc, char** argv)
+{
+  bool AllowDataChange(false), Worker(false), Valid(true);
+  unsigned int FirstBin(0), LastBin(0);
+  std::vector<std::string> FileNames;
+  for(int i(1); i < argc; ++i)
+  {
+    std::string Argument(argv[i]);
+    if(Argument == "-f") AllowDataChange = true;
+    else if(Argument == "-b" && i+1 < argc && std::sscanf(argv[i+1], "%u-%u", &FirstBin, &LastBin) == 2 && FirstBin <= LastBin)
+    {
+      Worker = true;
+      ++i;
+    }
+    else if(Argument == "-b") Valid = false;
+    else FileNames.push_back(argv[i]);
+  }
+  if(FileNames.empty() || !Valid)
+  {
+    std::cerr << "Invalid arguments. Each argument must be a fit result written by MinuitFit, -f draws fits whose data changed since, and -b <First>-<Last> only the images of those field bins. Example: \'./MinuitFitPlot NRQY0Fit.txt ERQY0Fit.txt\'." << std::endl;
+    return 0;
+  }
+  gROOT->SetBatch(true); //The plots are only saved.
+  int Failures(0);
+  const char* Recorded[] = {"Definitions", "Sets", "Recipes", "DefaultYieldUncertainty", "DefaultEnergyUncertainty", "LowField"};
+  for(unsigned int f(0); f < FileNames.size(); ++f)
+  {
+    FitResultObject Result;
+    bool Complete(Result.Load(FileNames.at(f)) && !Result.Get("ModelType").empty() && !Result.Get("ModelID").empty());
+    for(unsigned int k(0); k < sizeof(Recorded)/sizeof(Recorded[0]) && Complete; ++k) Complete = Result.Has(Recorded[k]);
+    if(!Complete)
+    {
+      std::cerr << "MinuitFitPlot: " << FileNames.at(f) << " is not a complete fit result." << std::endl;
+      ++Failures;
+      continue;
+    }
+    std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+    Settings->Set("FunctionDefinitions", Result.Get("Definitions"));
+    Settings->Set("DefaultYieldUncertainty", Result.Get("DefaultYieldUncertainty"));
+    Settings->Set("DefaultEnergyUncertainty", Result.Get("DefaultEnergyUncertainty"));
+    Settings->Set("LowField", Result.Get("LowField"));
+    Settings->Set("WarmStart", ""); //Nothing is minimized.
+    std::shared_ptr<const DataObject> Data(new DataObject(Split(Result.Get("Sets")), Split(Result.Get("Recipes")), std::stod(Settings->Query("DefaultYieldUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("LowField")), Settings->Query("FunctionDefinitions"), Settings->Query("CompileFormulas") == "true" ? Settings->Query("FormulaCache") : "", Settings->Query("FormulaCompiler"), std::map<std::string, RecipeResult>(), Settings->Query("DataCache") == "true"));
+    NESTModel::BasicModel Model(Result.Get("ModelType"), std::stoi(Result.Get("ModelID")), Settings, Data);
+    if(!Model.IsDefined() || !Model.LoadFitResult(FileNames.at(f), AllowDataChange))
+    {
+      std::cerr << "MinuitFitPlot: Could not draw the plots of " << FileNames.at(f) << "." << std::endl;
+      ++Failures;
+      continue;
+    }
+    if(Worker) Model.SetPlotBins(FirstBin, LastBin);
+    else Model.PrintResults();
+    Model.DrawGraphs();
+  }
+  return Failures ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+//C++ includes.
+#include <iostream> //Basic input and output.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <algorithm> //For std::find.
+#include <stdexcept> //Errors while fitting a model.
+
+//Custom includes.
+#include "ModelChain.h" //Header file for this implementation.
+#include "FunctionObject.h" //Reads the sets and recipes of each model.
+#include "DataObject.h" //Recipe results passed in memory.
+
+NESTModel::ModelChain::ModelChain(std::string modeltype, unsigned int id, unsigned int nthreads)
+{
+  ModelType = modeltype;
+  ID = id;
+  NThreads = nthreads;
+  NDone = 0;
+  Settings.reset(new SettingsObject("Settings.txt")); //Loaded once and shared by every model.
+}
+
+int NESTModel::ModelChain::AddNode(std::string Type, unsigned int ID, std::vector<std::string>& Path)
+{
+  //Depth-first walk through the recipes. Path holds the models being visited, to detect cycles.
+  std::string Name(Type + std::to_string(ID));
+  if(std::find(Path.begin(), Path.end(), Name) != Path.end())
+  {
+    std::cerr << "NESTModel::ModelChain::AddNode(): The recipes of " << Name << " depend on " << Name << " itself." << std::endl;
+    return -1;
+  }
+  if(NodeIndex.count(Name)) return NodeIndex.at(Name);
+  bool Found(false);
+  FunctionObject Definition(Settings->Query("FunctionDefinitions"), Type, ID, Found);
+  Node Current;
+  Current.Type = Type;
+  Current.ID = ID;
+  Current.External = !Found || Definition.GetSets().empty(); //Nothing to fit it to, so only its log can be used.
+  Current.Done = false;
+  Current.Failed = false;
+  std::vector<std::string> Recipes(Found ? Definition.GetRecipes() : std::vector<std::string>());
+  Path.push_back(Name);
+  for(unsigned int r(0); r < Recipes.size() && !Current.External; ++r)
+  {
+    std::string Recipe(Recipes.at(r));
+    if(Recipe.find(".") != std::string::npos || Recipe.size() < 2) continue; //"." means the set is used as is.
+    int Index(AddNode(Recipe.substr(0, Recipe.size()-1), std::stoi(Recipe.substr(Recipe.size()-1, 1)), Path)); //Same convention as DataObject: the last character is the ModelID.
+    if(Index < 0) return -1;
+    if(std::find(Current.Recipes.begin(), Current.Recipes.end(), Index) == Current.Recipes.end()) Current.Recipes.push_back(Index);
+  }
+  Path.pop_back();
+  Nodes.push_back(Current);
+  NodeIndex[Name] = Nodes.size()-1;
+  for(unsigned int r(0); r < Nodes.back().Recipes.size(); ++r) Nodes.at(Nodes.back().Recipes.at(r)).Users.push_back(Nodes.size()-1);
+  return Nodes.size()-1;
+}
+
+bool NESTModel::ModelChain::Run()
+{
+  std::vector<std::string> Path;
+  if(AddNode(ModelType, ID, Path) < 0) return false;
+  Pending.assign(Nodes.size(), 0);
+  for(unsigned int n(0); n < Nodes.size(); ++n) Pending.at(n) = Nodes.at(n).Recipes.size();
+  NDone = 0;
+  Pool.reset(new ThreadPool(NThreads));
+  {
+    std::unique_lock<std::mutex> Lock(StateMutex);
+    for(unsigned int n(0); n < Nodes.size(); ++n) if(Pending.at(n) == 0) Pool->Submit([this, n]() { Fit(n); });
+    AllDone.wait(Lock, [this]() { return NDone == Nodes.size(); });
+  }
+  Pool.reset();
+
+  //ROOT graphics and the redirection of std::cout are not thread safe, so the outputs are written serially, in
+  //the order the models were fit.
+  bool Success(true);
+  for(unsigned int n(0); n < Nodes.size(); ++n)
+  {
+    const Node& Current(Nodes.at(n));
+    if(Current.External) std::cout << Current.Type << Current.ID << ": read from " << Current.Type << Current.ID << "Log.txt" << std::endl;
+    else if(Current.Failed)
+    {
+      std::cerr << "NESTModel::ModelChain::Run(): " << Current.Type << Current.ID << " was not fit successfully, or one of its recipes wasn't." << std::endl;
+      Success = false;
+    }
+    else
+    {
+      Current.Model->PrintResults();
+      if(Current.Model->GetSettings()->Query("PlotAfterFit") == "true") Current.Model->DrawGraphs();
+    }
+  }
+  return Success;
+}
+
+void NESTModel::ModelChain::Fit(unsigned int Index)
+{
+  Node& Current(Nodes.at(Index));
+  bool Failed(false);
+  std::map<std::string, RecipeResult> Results;
+  for(unsigned int r(0); r < Current.Recipes.size(); ++r)
+  {
+    const Node& Recipe(Nodes.at(Current.Recipes.at(r)));
+    if(Recipe.Failed) Failed = true;
+    else if(!Recipe.External) Results[Recipe.Type + std::to_string(Recipe.ID)] = RecipeResult{Recipe.Model->GetParameters(), Recipe.Model->GetCovariance()};
+  }
+  if(!Failed && !Current.External)
+  {
+    try
+    {
+      Current.Model.reset(new BasicModel(Current.Type, Current.ID, Settings, BasicModel::LoadData(Settings, Current.Type, Current.ID, Results)));
+      Failed = !Current.Model->IsDefined() || !Current.Model->Minimize();
+      if(!Failed) Current.Model->SaveParameters(); //Also for later runs of the models using it on their own.
+    }
+    catch(const std::exception& Error) //Otherwise Run() would wait for this model forever.
+    {
+      std::cerr << "NESTModel::ModelChain::Fit(): " << Current.Type << Current.ID << ": " << Error.what() << std::endl;
+      Failed = true;
+    }
+  }
+  Finish(Index, Failed);
+}
+
+void NESTModel::ModelChain::Finish(unsigned int Index, bool Failed)
+{
+  //Starts every user of this node whose recipes are now all done.
+  std::lock_guard<std::mutex> Lock(StateMutex);
+  Nodes.at(Index).Done = true;
+  Nodes.at(Index).Failed = Failed;
+  for(unsigned int u(0); u < Nodes.at(Index).Users.size(); ++u)
+  {
+    unsigned int User(Nodes.at(Index).Users.at(u));
+    if(--Pending.at(User) == 0) Pool->Submit([this, User]() { Fit(User); });
+  }
+  if(++NDone == Nodes.size()) AllDone.notify_all();
+}
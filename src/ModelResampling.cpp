@@ -0,0 +1,128 @@
+//C++ includes.
+#include <iostream> //Basic input and output.
+#include <fstream> //Basic file input and output.
+#include <sstream> //Useful for number -> string conversion.
+#include <iomanip> //Set precision for output stream.
+#include <vector> //STL vector.
+#include <string> //Basic string.
+#include <memory> //For using shared_ptr.
+#include <future> //Replicas running on the thread pool.
+#include <random> //Per-replica random number generators.
+#include <limits> //For std::numeric_limits.
+#include <cmath> //Basic math functions.
+
+//Custom includes.
+#include "ModelResampling.h" //Header file for this implementation.
+#include "ThreadPool.h" //Runs the replicas concurrently.
+#include "DataObject.h" //Resampled copies of the data.
+
+NESTModel::ModelResampling::ModelResampling(std::string modeltype, unsigned int id, Method method, unsigned int nthreads)
+{
+  ModelType = modeltype;
+  ID = id;
+  Mode = method;
+  NThreads = nthreads;
+  NConverged = 0;
+  Settings.reset(new SettingsObject("Settings.txt")); //Loaded once and shared by every replica.
+  NReplicas = std::stoi(Settings->Query("BootstrapReplicas"));
+  Seed = std::stoul(Settings->Query("ResamplingSeed"));
+}
+
+bool NESTModel::ModelResampling::Run()
+{
+  Nominal.reset(new BasicModel(ModelType, ID, Settings, BasicModel::LoadData(Settings, ModelType, ID)));
+  if(!Nominal->IsDefined() || !Nominal->Minimize())
+  {
+    std::cerr << "NESTModel::ModelResampling::Run(): The nominal fit of " << ModelType << ID << " failed, so there is nothing to start the replicas from." << std::endl;
+    return false;
+  }
+  if(Mode == Jackknife) NReplicas = Nominal->GetCovarianceFactor().GetNBlocks(); //One replica per data set.
+  unsigned int NPar(Nominal->GetNPar());
+  Means.assign(NPar, 0);
+  SumSquares.assign(NPar, 0);
+  NConverged = 0;
+
+  Output.open(static_cast<std::stringstream&>(std::stringstream("").flush() << (Mode == Bootstrap ? "Bootstrap_" : "Jackknife_") << ModelType << ID << ".csv").str().c_str());
+  Output << "#Replica,Converged,Chi2";
+  for(unsigned int i(0); i < NPar; ++i) Output << ",a" << i;
+  Output << std::endl;
+  Output << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  std::vector<double> Start(Nominal->GetParameters()); //Warm start of every replica.
+  std::shared_ptr<const DataObject> NominalData(Nominal->GetData());
+  {
+    ThreadPool Pool(NThreads);
+    std::vector< std::future<void> > Done;
+    for(unsigned int Replica(0); Replica < NReplicas; ++Replica)
+    {
+      Done.push_back(Pool.Submit([this, Replica, Start, NominalData]()
+				 {
+				   std::shared_ptr<const DataObject> Resampled(new DataObject(*NominalData, Multiplicity(Replica)));
+				   BasicModel Model(ModelType, ID, Settings, Resampled);
+				   if(Model.IsDefined()) Model.Minimize(Start);
+				   Record(Replica, Model);
+				 }));
+    }
+    for(unsigned int Replica(0); Replica < Done.size(); ++Replica) Done.at(Replica).get();
+  }
+  Output.close();
+  PrintSummary(std::cout);
+  return NConverged > 1;
+}
+
+std::vector<unsigned int> NESTModel::ModelResampling::Multiplicity(unsigned int Replica)
+{
+  //Number of times each point of the nominal data is used by the replica. Bootstrap replicas redraw every data
+  //set separately, keeping its number of points. The generator only depends on Seed and Replica, so a replica
+  //is the same whichever thread runs it and however many replicas there are.
+  const CovarianceObject& Blocks(Nominal->GetCovarianceFactor());
+  std::vector<unsigned int> Counts(Blocks.GetN(), Mode == Jackknife ? 1 : 0);
+  if(Mode == Jackknife)
+  {
+    for(unsigned int i(0); i < Blocks.GetBlockSize(Replica); ++i) Counts.at(Blocks.GetBlockOffset(Replica) + i) = 0;
+    return Counts;
+  }
+  std::seed_seq Sequence{static_cast<unsigned long>(Seed), static_cast<unsigned long>(Replica)};
+  std::mt19937_64 Generator(Sequence);
+  for(unsigned int b(0); b < Blocks.GetNBlocks(); ++b)
+  {
+    std::uniform_int_distribution<unsigned int> Draw(0, Blocks.GetBlockSize(b) - 1);
+    for(unsigned int i(0); i < Blocks.GetBlockSize(b); ++i) ++Counts.at(Blocks.GetBlockOffset(b) + Draw(Generator));
+  }
+  return Counts;
+}
+
+void NESTModel::ModelResampling::Record(unsigned int Replica, BasicModel& Model)
+{
+  std::lock_guard<std::mutex> Lock(OutputMutex);
+  Output << Replica << ',' << (Model.IsConverged() ? 1 : 0) << ',' << (Model.IsConverged() ? Model.GetChisquare() : 0);
+  for(unsigned int i(0); i < Means.size(); ++i) Output << ',' << (Model.IsConverged() ? Model.GetParameters().at(i) : 0);
+  Output << std::endl; //Flushed, so that the replicas finished so far survive an interrupted run.
+  if(!Model.IsConverged()) return;
+  ++NConverged;
+  for(unsigned int i(0); i < Means.size(); ++i)
+  {
+    double Delta(Model.GetParameters().at(i) - Means.at(i));
+    Means.at(i) += Delta/NConverged;
+    SumSquares.at(i) += Delta*(Model.GetParameters().at(i) - Means.at(i));
+  }
+}
+
+void NESTModel::ModelResampling::PrintSummary(std::ostream& out)
+{
+  //Bootstrap errors are the spread of the replicas; jackknife errors are sqrt((n-1)/n*sum (a_i - mean)^2).
+  out << "******************************************************" << std::endl;
+  out << (Mode == Bootstrap ? "Bootstrap" : "Jackknife") << " of " << ModelType << ID << ": " << NConverged << " of " << NReplicas << " replicas converged" << std::endl;
+  if(NConverged < 2)
+  {
+    out << "******************************************************" << std::endl;
+    return;
+  }
+  for(unsigned int i(0); i < Means.size(); ++i)
+  {
+    double Error(Mode == Bootstrap ? std::sqrt(SumSquares.at(i)/(NConverged-1)) : std::sqrt(SumSquares.at(i)*(NConverged-1)/NConverged));
+    out << "Parameter " << i << ": " << Nominal->GetParameters().at(i) << " +/- " << Error
+	<< " (fit error " << Nominal->GetParameterErrors().at(i) << ", replica mean " << Means.at(i) << ")" << std::endl;
+  }
+  out << "******************************************************" << std::endl;
+}
@@ -0,0 +1,159 @@
+//C++ includes.
+#include <iostream> //Basic input and output.
+#include <fstream> //Basic file input and output.
+#include <sstream> //Useful for number -> string conversion.
+#include <vector> //STL vector.
+#include <string> //Basic string.
+#include <memory> //For using shared_ptr.
+#include <future> //Workers running on the thread pool.
+#include <limits> //For std::numeric_limits.
+#include <cstring> //For std::memcpy.
+#include <algorithm> //For std::min and std::max.
+
+//Custom includes.
+#include "ModelScan.h" //Header file for this implementation.
+#include "ThreadPool.h" //Runs the workers concurrently.
+
+namespace
+{
+  std::vector<std::string> SplitList(const std::string& List)
+  {
+    std::vector<std::string> Items;
+    std::string Item;
+    std::stringstream Stream(List);
+    while(std::getline(Stream, Item, ',')) if(!Item.empty()) Items.push_back(Item);
+    return Items;
+  }
+
+  template<class T> void Append(std::vector<char>& Buffer, T Value)
+  {
+    char Bytes[sizeof(T)];
+    std::memcpy(Bytes, &Value, sizeof(T));
+    Buffer.insert(Buffer.end(), Bytes, Bytes + sizeof(T));
+  }
+}
+
+NESTModel::ModelScan::ModelScan(std::string modeltype, unsigned int id, unsigned int nthreads)
+{
+  ModelType = modeltype;
+  ID = id;
+  NThreads = nthreads;
+  NCells = 0;
+  NextCell = 0;
+  Settings.reset(new SettingsObject("Settings.txt")); //Loaded once and shared by every worker.
+  Profile = Settings->Query("ScanProfile") == "true";
+}
+
+bool NESTModel::ModelScan::Run()
+{
+  Data = BasicModel::LoadData(Settings, ModelType, ID);
+  if(!Data) return false;
+  BasicModel Nominal(ModelType, ID, Settings, Data);
+  if(!Nominal.IsDefined() || !Nominal.Minimize())
+  {
+    std::cerr << "NESTModel::ModelScan::Run(): The fit of " << ModelType << ID << " failed, so there is no best fit to scan around." << std::endl;
+    return false;
+  }
+  BestFit = Nominal.GetParameters();
+
+  std::vector<std::string> Parameters(SplitList(Settings->Query("ScanParameters"))), Lows(SplitList(Settings->Query("ScanLow"))), Highs(SplitList(Settings->Query("ScanHigh"))), Points(SplitList(Settings->Query("ScanPoints")));
+  if(Parameters.empty() || Lows.size() != Parameters.size() || Highs.size() != Parameters.size() || Points.size() != Parameters.size())
+  {
+    std::cerr << "NESTModel::ModelScan::Run(): ScanParameters, ScanLow, ScanHigh, and ScanPoints must list the same number of values." << std::endl;
+    return false;
+  }
+  NCells = 1;
+  for(unsigned int d(0); d < Parameters.size(); ++d)
+  {
+    Scanned.push_back(std::stoul(Parameters.at(d)));
+    Low.push_back(std::stod(Lows.at(d)));
+    High.push_back(std::stod(Highs.at(d)));
+    NPoints.push_back(std::max(1, std::stoi(Points.at(d))));
+    NCells *= NPoints.back();
+    if(Scanned.back() >= BestFit.size())
+    {
+      std::cerr << "NESTModel::ModelScan::Run(): " << ModelType << ID << " has no parameter " << Scanned.back() << "." << std::endl;
+      return false;
+    }
+  }
+
+  Output.open(static_cast<std::stringstream&>(std::stringstream("").flush() << "Scan_" << ModelType << ID << ".bin").str().c_str(), std::ios::binary);
+  std::vector<char> Header;
+  const char Magic[8] = "MFSCAN1";
+  Header.insert(Header.end(), Magic, Magic + 8);
+  Append<uint32_t>(Header, Scanned.size());
+  Append<uint32_t>(Header, BestFit.size());
+  Append<uint32_t>(Header, Profile ? 1 : 0);
+  for(unsigned int d(0); d < Scanned.size(); ++d)
+  {
+    Append<uint32_t>(Header, Scanned.at(d));
+    Append<uint32_t>(Header, NPoints.at(d));
+    Append<double>(Header, Low.at(d));
+    Append<double>(Header, High.at(d));
+  }
+  Flush(Header);
+
+  NextCell = 0;
+  {
+    ThreadPool Pool(NThreads);
+    std::vector< std::future<void> > Done;
+    for(unsigned int Worker(0); Worker < Pool.GetNThreads(); ++Worker)
+    {
+      std::shared_ptr<BasicModel> Model(new BasicModel(ModelType, ID, Settings, Data)); //Each worker has its own workspaces and minimizer.
+      Done.push_back(Pool.Submit([this, Model]() { Work(Model); }));
+    }
+    for(unsigned int Worker(0); Worker < Done.size(); ++Worker) Done.at(Worker).get();
+  }
+  Output.close();
+  std::cout << "Scanned " << NCells << " cells of " << ModelType << ID << " into Scan_" << ModelType << ID << ".bin" << std::endl;
+  return Output.good();
+}
+
+void NESTModel::ModelScan::Work(std::shared_ptr<BasicModel> Model)
+{
+  //Takes Batch cells at a time until there are none left. Fixed cells cost a single chi-square evaluation, so
+  //they are taken in large batches; profiled cells are taken one by one, since their cost varies a lot.
+  const uint64_t Batch(Profile ? 1 : 1024);
+  const std::size_t RecordSize(sizeof(uint64_t) + sizeof(double)*(Profile ? 1 + BestFit.size() : 1));
+  std::vector<char> Buffer;
+  Buffer.reserve(RecordSize*4096);
+  std::vector<double> p(BestFit);
+  for(uint64_t First(NextCell.fetch_add(Batch)); First < NCells; First = NextCell.fetch_add(Batch))
+  {
+    for(uint64_t Cell(First); Cell < std::min(NCells, First + Batch); ++Cell)
+    {
+      CellParameters(Cell, p);
+      double Chi2;
+      if(Profile)
+      {
+	if(Model->Minimize(p, Scanned)) Chi2 = Model->GetChisquare();
+	else Chi2 = std::numeric_limits<double>::quiet_NaN();
+	if(Model->IsConverged()) p = Model->GetParameters();
+      }
+      else Chi2 = Model->Objective(p.data());
+      Append<uint64_t>(Buffer, Cell);
+      Append<double>(Buffer, Chi2);
+      if(Profile) for(unsigned int i(0); i < p.size(); ++i) Append<double>(Buffer, p.at(i));
+      if(Buffer.size() >= RecordSize*4096) Flush(Buffer);
+      if(Profile) p = BestFit; //Every profile starts from the best fit, so the result doesn't depend on which worker ran the cell.
+    }
+  }
+  Flush(Buffer);
+}
+
+void NESTModel::ModelScan::CellParameters(uint64_t Cell, std::vector<double>& p)
+{
+  for(unsigned int d(0); d < Scanned.size(); ++d)
+  {
+    unsigned int k(Cell % NPoints.at(d));
+    Cell /= NPoints.at(d);
+    p.at(Scanned.at(d)) = NPoints.at(d) > 1 ? Low.at(d) + (High.at(d) - Low.at(d))*k/(NPoints.at(d) - 1) : Low.at(d);
+  }
+}
+
+void NESTModel::ModelScan::Flush(std::vector<char>& Buffer)
+{
+  std::lock_guard<std::mutex> Lock(OutputMutex);
+  Output.write(Buffer.data(), Buffer.size());
+  Buffer.clear();
+}
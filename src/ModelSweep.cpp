@@ -0,0 +1,188 @@
+//C++ includes.
+#include <iostream> //Basic input and output.
+#include <fstream> //Basic file input and output.
+#include <sstream> //Useful for number -> string conversion.
+#include <iomanip> //Set precision for output stream.
+#include <vector> //STL vector.
+#include <string> //Basic string.
+#include <memory> //For using shared_ptr.
+#include <future> //Results of the fits running on the thread pool.
+#include <algorithm> //For sorting the ranking.
+#include <cmath> //Basic math functions.
+#include <map> //STL map.
+#include <cstdint> //For uint64_t.
+
+//Custom includes.
+#include "ModelSweep.h" //Header file for this implementation.
+#include "ThreadPool.h" //Runs the fits concurrently.
+#include "FunctionObject.h" //Lists the ModelIDs of the ModelType.
+#include "FitStoreObject.h" //Results of earlier fits, for ranking without fitting.
+#include "HashObject.h" //Compares the functions of stored fits with the definitions.
+
+NESTModel::ModelSweep::ModelSweep(std::string modeltype, unsigned int nthreads)
+{
+  ModelType = modeltype;
+  NThreads = nthreads;
+  Settings.reset(new SettingsObject("Settings.txt")); //Loaded once and shared by every model.
+}
+
+bool NESTModel::ModelSweep::Run()
+{
+  std::vector<unsigned int> ModelIDs(FunctionObject::FindModelIDs(Settings->Query("FunctionDefinitions"), ModelType));
+  if(ModelIDs.empty())
+  {
+    std::cerr << "NESTModel::ModelSweep::Run(): No models of type " << ModelType << " were found in definitions file." << std::endl;
+    return false;
+  }
+  for(unsigned int i(0); i < ModelIDs.size() && !Data; ++i) Data = BasicModel::LoadData(Settings, ModelType, ModelIDs.at(i)); //Every ID of a ModelType fits the same sets and recipes.
+  if(!Data) return false;
+
+  Models.clear();
+  std::vector< std::future< std::shared_ptr<BasicModel> > > Fits;
+  {
+    ThreadPool Pool(NThreads);
+    for(unsigned int i(0); i < ModelIDs.size(); ++i)
+    {
+      std::string Type(ModelType);
+      unsigned int ID(ModelIDs.at(i));
+      std::shared_ptr<SettingsObject> SharedSettings(Settings);
+      std::shared_ptr<const DataObject> SharedData(Data);
+      Fits.push_back(Pool.Submit([Type, ID, SharedSettings, SharedData]()
+				 {
+				   std::shared_ptr<BasicModel> Model(new BasicModel(Type, ID, SharedSettings, SharedData));
+				   Model->Minimize();
+				   return Model;
+				 }));
+    }
+    for(unsigned int i(0); i < Fits.size(); ++i) Models.push_back(Fits.at(i).get());
+  }
+
+  //ROOT graphics and the redirection of std::cout are not thread safe, so the outputs are written serially.
+  for(unsigned int i(0); i < Models.size(); ++i)
+  {
+    if(!Models.at(i)->IsConverged()) continue;
+    Models.at(i)->PrintResults();
+    Models.at(i)->SaveParameters();
+    if(Models.at(i)->GetSettings()->Query("PlotAfterFit") == "true") Models.at(i)->DrawGraphs();
+    Models.at(i)->SaveContours(); //Runs the pairs of parameters concurrently itself.
+  }
+  std::ofstream RankingFile(static_cast<std::stringstream&>(std::stringstream("").flush() << "FitRanking_" << ModelType << ".txt").str().c_str());
+  PrintRanking(RankingFile);
+  PrintRanking(std::cout);
+  RankingFile.close();
+  return true;
+}
+
+void NESTModel::ModelSweep::PrintRanking(std::ostream& out)
+{
+  //Rank by reduced chi^2, AIC = chi^2 + 2k, and BIC = chi^2 + k*ln(N). Models that did not converge are listed last.
+  std::vector<unsigned int> Order, AICRank(Models.size(), 0), BICRank(Models.size(), 0);
+  std::vector<double> ReducedChi2, AIC, BIC;
+  for(unsigned int i(0); i < Models.size(); ++i)
+  {
+    double k(Models.at(i)->GetNPar()), N(Models.at(i)->GetNData());
+    ReducedChi2.push_back(Models.at(i)->GetChisquare()/(N-k));
+    AIC.push_back(Models.at(i)->GetChisquare() + 2.0*k);
+    BIC.push_back(Models.at(i)->GetChisquare() + k*std::log(N));
+    Order.push_back(i);
+  }
+  std::vector<unsigned int> ByAIC(Order), ByBIC(Order);
+  std::stable_sort(Order.begin(), Order.end(), [&](unsigned int a, unsigned int b) { return Models.at(a)->IsConverged() != Models.at(b)->IsConverged() ? Models.at(a)->IsConverged() : ReducedChi2.at(a) < ReducedChi2.at(b); });
+  std::stable_sort(ByAIC.begin(), ByAIC.end(), [&](unsigned int a, unsigned int b) { return Models.at(a)->IsConverged() != Models.at(b)->IsConverged() ? Models.at(a)->IsConverged() : AIC.at(a) < AIC.at(b); });
+  std::stable_sort(ByBIC.begin(), ByBIC.end(), [&](unsigned int a, unsigned int b) { return Models.at(a)->IsConverged() != Models.at(b)->IsConverged() ? Models.at(a)->IsConverged() : BIC.at(a) < BIC.at(b); });
+  for(unsigned int i(0); i < Models.size(); ++i)
+  {
+    AICRank.at(ByAIC.at(i)) = i+1;
+    BICRank.at(ByBIC.at(i)) = i+1;
+  }
+
+  out << "******************************************************" << std::endl;
+  out << "Ranking of " << ModelType << " models" << std::endl;
+  out << std::left << std::setw(6) << "Rank" << std::setw(6) << "ID" << std::setw(6) << "NPar"
+      << std::setw(14) << "Chi^2" << std::setw(14) << "Red. Chi^2"
+      << std::setw(14) << "AIC" << std::setw(10) << "AICRank"
+      << std::setw(14) << "BIC" << std::setw(10) << "BICRank"
+      << std::setw(12) << "Time [s]" << std::setw(12) << "FCN Calls" << "Status" << std::endl;
+  for(unsigned int i(0); i < Order.size(); ++i)
+  {
+    unsigned int m(Order.at(i));
+    std::shared_ptr<BasicModel> Model(Models.at(m));
+    out << std::left << std::setw(6) << i+1 << std::setw(6) << Model->GetID() << std::setw(6) << Model->GetNPar();
+    if(Model->IsConverged())
+    {
+      out << std::setprecision(6) << std::setw(14) << Model->GetChisquare() << std::setw(14) << ReducedChi2.at(m)
+	  << std::setw(14) << AIC.at(m) << std::setw(10) << AICRank.at(m)
+	  << std::setw(14) << BIC.at(m) << std::setw(10) << BICRank.at(m);
+    }
+    else out << std::setw(14) << "-" << std::setw(14) << "-" << std::setw(14) << "-" << std::setw(10) << "-" << std::setw(14) << "-" << std::setw(10) << "-";
+    out << std::setprecision(3) << std::setw(12) << Model->GetFitTime() << std::setw(12) << Model->GetNCalls()
+	<< (Model->IsConverged() ? "converged" : (Model->IsDefined() ? "failed" : "undefined")) << std::endl;
+  }
+  out << "******************************************************" << std::endl;
+  out << std::right;
+}
+
+bool NESTModel::ModelSweep::PrintStoreRanking(std::string modeltype, std::ostream& out)
+{
+  //Ranks the latest converged fit of each ModelID in the fit store by reduced chi^2, without fitting or reading text.
+  //Fits of a function that was changed in the definitions file since are left out, as they no longer describe the model.
+  SettingsObject StoreSettings("Settings.txt");
+  FitStoreObject Store(StoreSettings.Query("FitStore"));
+  if(StoreSettings.Query("FitStore") == "" || !Store.Load()) return false;
+  const std::vector<std::string>& Types(Store.GetModelTypes());
+  const std::vector<unsigned int>& IDs(Store.GetModelIDs());
+  std::map<unsigned int, uint64_t> FormulaHashes; //Of the current definitions, 0 for IDs that are no longer defined.
+  std::size_t NChanged(0);
+  auto IsCurrent = [&](std::size_t i) -> bool
+  {
+    if(FormulaHashes.find(IDs[i]) == FormulaHashes.end())
+    {
+      bool Found(false);
+      FunctionObject Definition(StoreSettings.Query("FunctionDefinitions"), modeltype, IDs[i], Found);
+      HashObject Formula;
+      Formula.Add(Definition.GetFunction()); //As in BasicModel::StoreFit().
+      FormulaHashes[IDs[i]] = Found ? Formula.Get() : 0;
+    }
+    if(Store.GetFormulaHashes()[i] == FormulaHashes[IDs[i]]) return true;
+    ++NChanged;
+    return false;
+  };
+  std::vector<std::size_t> Latest(Store.Select([&](std::size_t i) { return Types[i] == modeltype && (Store.GetFlags()[i] & 1) && IsCurrent(i); }));
+  std::vector<std::size_t> Records;
+  std::vector<bool> Seen;
+  for(std::size_t r(Latest.size()); r-- > 0;) //Records are in the order they were appended.
+  {
+    unsigned int id(IDs[Latest.at(r)]);
+    if(id >= Seen.size()) Seen.resize(id+1, false);
+    if(Seen.at(id)) continue;
+    Seen.at(id) = true;
+    Records.push_back(Latest.at(r));
+  }
+  std::vector<double> ReducedChi2(Store.GetNRecords(), 0);
+  for(std::size_t r(0); r < Records.size(); ++r)
+  {
+    std::size_t i(Records.at(r));
+    ReducedChi2.at(i) = Store.GetChisquares()[i]/(static_cast<double>(Store.GetNDatas()[i]) - Store.GetNFrees()[i]); //Fixed parameters don't take degrees of freedom.
+  }
+  Store.Rank(Records, ReducedChi2);
+
+  out << "******************************************************" << std::endl;
+  out << "Ranking of stored " << modeltype << " fits" << std::endl;
+  out << std::left << std::setw(6) << "Rank" << std::setw(6) << "ID" << std::setw(6) << "NPar"
+      << std::setw(14) << "Chi^2" << std::setw(14) << "Red. Chi^2" << std::setw(14) << "EDM"
+      << std::setw(12) << "Time [s]" << std::setw(12) << "FCN Calls" << "Status" << std::endl;
+  for(std::size_t r(0); r < Records.size(); ++r)
+  {
+    std::size_t i(Records.at(r));
+    out << std::left << std::setw(6) << r+1 << std::setw(6) << IDs[i] << std::setw(6) << Store.GetNPars()[i]
+	<< std::setprecision(6) << std::setw(14) << Store.GetChisquares()[i] << std::setw(14) << ReducedChi2.at(i) << std::setw(14) << Store.GetEDMs()[i]
+	<< std::setprecision(3) << std::setw(12) << Store.GetFitTimes()[i] << std::setw(12) << Store.GetNCalls()[i]
+	<< Store.GetStatuses()[i] << ((Store.GetFlags()[i] & 2) ? " (cached)" : "") << std::endl;
+  }
+  if(NChanged) out << NChanged << " converged fits of functions that were changed since were left out." << std::endl;
+  out << "******************************************************" << std::endl;
+  out << std::right;
+  return true;
+}
+
+std::vector< std::shared_ptr<NESTModel::BasicModel> >& NESTModel::ModelSweep::GetModels() { return Models; }
@@ -9,10 +9,23 @@
 #include <sstream> //Useful for number -> string conversion.
 #include <string> //Basic string.
 #include <iomanip> //Set precision for output stream.
+#include <chrono> //Wall time of the minimization.
+#include <future> //Chunks of the data points and starts running on the thread pool.
+#include <random> //Samples the starting points of a multi-start fit.
+#include <limits> //For std::numeric_limits.
+#include <atomic> //Counts the models, to name their functions.
+#include <thread> //For std::thread::hardware_concurrency.
+
+//POSIX includes
+#include <spawn.h> //Starts the plotting workers.
+#include <sys/wait.h> //Waits for the plotting workers.
+#include <unistd.h> //Finds the plotting program.
+extern char** environ; //Passed on to the plotting workers.
 
 //ROOT includes
 #include "TMath.h" //Basic math functions.
 #include "TGraphAsymmErrors.h" //ROOT 1D graph with asymmetric error bars.
+#include "TGraph.h" //Confidence contours.
 #include "TAxis.h" //For using the TAxis object.
 #include "TCanvas.h" //For using the TCanvas object.
 #include "TF2.h" //ROOT 2D function.
@@ -24,23 +37,58 @@
 #include "TH2F.h" //Dummy to create a TPaletteAxis object.
 #include "TPaletteAxis.h" //Gradient axis bar.
 #include "TGaxis.h" //Axis contained in TPaletteAxis.
-#include "TSystem.h" //Access to command line.
+#include "Math/Factory.h" //Creates the minimizer from its name.
 
 //Custom includes
 #include "Models.h" //Header file for this implementation.
 #include "DataObject.h" //Modularizes the input of data sets from .txt files.
 #include "FunctionObject.h" //Modularizes the input of model functions from a .txt file.
 #include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "ExpressionObject.h" //Compiled model function, for evaluating many points at once.
+#include "CompiledFunctionObject.h" //Model function built into a shared library.
+#include "ThreadPool.h" //Evaluates the data points concurrently.
+#include "PairwiseSum.h" //Sums the chi-square in the same order for any number of threads.
+#include "HashObject.h" //Key of the fit cache.
+#include "FitCacheObject.h" //Results of earlier fits with the same inputs.
+#include "FitResultObject.h" //Fit results for drawing the plots later.
+#include "FitStoreObject.h" //Results of every fit, for ranking many of them.
 
 NESTModel::BasicModel::BasicModel(std::string modeltype, unsigned int id)
 {
   ID = id; //Set the model ID number.
+  ModelType = modeltype; //Set the model type, which specifies where to look in the function definitions
   Settings.reset(new SettingsObject("Settings.txt")); //Set and load the settings file. This location is relative to where the program is being run.
+  Initialize(std::shared_ptr<const DataObject>()); //No data given, so it is loaded from the sets of this model.
+}
+
+NESTModel::BasicModel::BasicModel(std::string modeltype, unsigned int id, std::shared_ptr<SettingsObject> settings, std::shared_ptr<const DataObject> data)
+{
+  ID = id; //Set the model ID number.
+  ModelType = modeltype; //Set the model type, which specifies where to look in the function definitions
+  Settings = settings; //Settings are only read, so they may be shared with other models.
+  Initialize(data);
+}
+
+void NESTModel::BasicModel::Initialize(std::shared_ptr<const DataObject> data)
+{
   NData = 0; //NData should be zero until data is loaded.
   Success = false; //By default, no success.
+  Converged = false; //Nothing has been minimized yet.
+  Chisquare = 0;
+  EDM = 0;
+  FitTime = 0;
+  Status = -1; //Not minimized yet.
+  NFree = 0;
+  FromCache = false;
+  NStarts = 1;
+  BestStart = 0;
+  StartCalls = 0;
+  FitResultDataChanged = false;
+  PlotWorker = false;
+  PlotBinFirst = 0;
+  PlotBinLast = 0;
   DefaultField = -1; //-1 tells the operator() function that both the energy and field were provided.
                      //Otherwise, operator() will use the value in DefaultField for the field value.
-  ModelType = modeltype; //Set the model type, which specifies where to look in the function definitions
   FuncObject.reset(new FunctionObject(Settings->Query("FunctionDefinitions"), ModelType, ID, Success)); //Load the function object from the functions definitions file. Success is captured in "Success".
   if(Success)
   {
@@ -51,30 +99,92 @@ NESTModel::BasicModel::BasicModel(std::string modeltype, unsigned int id)
     Sets = FuncObject->GetSets(); //Load list of sets.
     Recipes = FuncObject->GetRecipes(); //Load list of recipes.
     NPar = InitialVect.size(); //Set the number of parameters.
-    MinuitMinimizer.reset(new TMinuit(NPar)); //Create the TMinuit object.
+    if(Settings->Query("WarmStart") != "") LoadWarmStart(Settings->Query("WarmStart") == "log" ? ModelType + std::to_string(ID) : Settings->Query("WarmStart"));
+    UseCovariance = Settings->Query("Chi2") != "EffectiveVariance"; //Which chi-square is minimized.
+    Minimizer.reset(ROOT::Math::Factory::CreateMinimizer("Minuit2", Settings->Query("Algorithm"))); //Create the minimizer. Each model owns its own, so fits don't share any state.
+    FCN.reset(new ModelFCN(*this)); //Create the function to be minimized, bound to this model.
+    GradFCN.reset(new ModelGradFCN(*this));
     Is2DFit = FuncObject->GetFunction().find("y") != std::string::npos;
-    if(Is2DFit) ModelFunction2D.reset(new TF2("ModelFunction", FuncObject->GetFunction().c_str(), 0, 1000, 0, 5000)); //Create the 2D function that will do the heavy lifting for the function evaluating.
-    else ModelFunction1D.reset(new TF1("ModelFunction", FuncObject->GetFunction().c_str(),0,1000));
-    DataObject DataObj(Sets, Recipes, std::stod(Settings->Query("DefaultYieldUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("LowField"))); //Load data from the data file.
-    DataX = DataObj.GetDataX(); //Set energy data.
-    DataY = DataObj.GetDataY(); //Set field data.
-    DataZ = DataObj.GetDataZ(); //Set yield data.
-    DataXErrLow = DataObj.GetDataXErrLow(); //Set lower energy error bar.
-    DataXErrHigh = DataObj.GetDataXErrHigh(); //Set upper energy error bar.
-    DataYErrLow = DataObj.GetDataYErrLow(); //Set lower field error bar.
-    DataYErrHigh = DataObj.GetDataYErrHigh(); //Set upper field error bar.
-    DataZErrLow = DataObj.GetDataZErrLow(); //Set lower yield error bar.
-    DataZErrHigh = DataObj.GetDataZErrHigh(); //Set upper yield error bar.
-    NData = DataX.size(); //Set NData properly.
-    Covariance.ResizeTo(NData, NData);
-    Covariance = DataObj.GetCovariance(); //Set covariance matrix.
-    InvCovariance.ResizeTo(NData, NData);
-    InvCovariance = Covariance.Invert();
-    //Covariance.Print();
+    static std::atomic<unsigned int> NModels(0);
+    std::string FunctionName("ModelFunction" + ModelType + std::to_string(ID) + "_" + std::to_string(NModels++)); //Unique name, so that concurrent models (even of the same ID) don't replace each other in ROOT's list of functions.
+    if(Settings->Query("CompileFormulas") == "true")
+    {
+      bool Built(false);
+      Compiled.reset(new CompiledFunctionObject(FuncObject->GetFunction(), Settings->Query("FormulaCache"), Settings->Query("FormulaCompiler"), Built));
+      if(!Built || Compiled->GetNPar() > NPar) Compiled.reset(); //Fall back to TFormula.
+    }
+    if(Is2DFit)
+    {
+      if(Compiled) ModelFunction2D.reset(new TF2(FunctionName.c_str(), Compiled->GetFunction(), 0, 1000, 0, 5000, NPar)); //No JIT compilation of the formula.
+      else ModelFunction2D.reset(new TF2(FunctionName.c_str(), FuncObject->GetFunction().c_str(), 0, 1000, 0, 5000)); //Create the 2D function that will do the heavy lifting for the function evaluating.
+    }
+    else
+    {
+      if(Compiled) ModelFunction1D.reset(new TF1(FunctionName.c_str(), Compiled->GetFunction(), 0, 1000, NPar));
+      else ModelFunction1D.reset(new TF1(FunctionName.c_str(), FuncObject->GetFunction().c_str(),0,1000));
+    }
+    unsigned int FitThreads(std::stoi(Settings->Query("FitThreads")));
+    if(FitThreads != 1) Pool.reset(new ThreadPool(FitThreads)); //Zero uses every core.
+    bool Parsed(false);
+    Expression.reset(new ExpressionObject(FuncObject->GetFunction(), Parsed)); //Evaluates all of the data points at once in the chi-square.
+    if(Parsed && Expression->GetNPar() <= NPar) ExpressionWorkspaces.assign(Pool ? Pool->GetNThreads() : 1, std::vector<double>(Expression->GetGradientWorkspaceSize(), 0)); //Large enough for the gradient too.
+    else Expression.reset(); //Not supported by the compiler, or it reads more parameters than defined, so TFormula is kept.
+    if(data) Data = data; //Use the data that was already loaded for this ModelType.
+    else Data.reset(new DataObject(Sets, Recipes, std::stod(Settings->Query("DefaultYieldUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("LowField")), Settings->Query("FunctionDefinitions"), Settings->Query("CompileFormulas") == "true" ? Settings->Query("FormulaCache") : "", Settings->Query("FormulaCompiler"), std::map<std::string, RecipeResult>(), Settings->Query("DataCache") == "true")); //Load data from the data file.
+    NData = Data->GetDataX().size(); //Set NData properly.
+    Residuals.assign(NData, 0); //Workspace reused by every evaluation of the chi-square.
+    Solved.assign(std::max(NData, Data->GetCovarianceFactor().GetWorkspaceSize()), 0); //Also holds the slopes of the effective variance.
+    Weights.assign(NData, 0);
+    Partials.assign((NData + ChunkSize - 1)/ChunkSize*NPar, 0);
+    if(!Data->IsValid())
+    {
+      std::cerr << "NESTModel::BasicModel::BasicModel(): The covariance of the data sets could not be factorized." << std::endl;
+      Success = false;
+    }
   }
   else std::cerr << "NESTModel::BasicModel::BasicModel(): A proper model was not found in definitions file." << std::endl;
 }
 
+bool NESTModel::BasicModel::LoadWarmStart(std::string Model)
+{
+  //Replaces P by the parameters saved in <Model>Log.txt by SaveParameters(), and S by their errors, which
+  //MIGRAD takes as its first estimate of the error matrix. A refit of slightly changed data then starts next
+  //to the minimum, with the right scale for each parameter.
+  std::ifstream Input(Model + "Log.txt");
+  std::vector< std::vector<double> > Rows;
+  std::string Line, Item;
+  while(std::getline(Input, Line))
+  {
+    if(Line.empty()) continue;
+    std::stringstream Stream(Line);
+    Rows.push_back(std::vector<double>());
+    try { while(std::getline(Stream, Item, ',')) Rows.back().push_back(std::stod(Item)); }
+    catch(const std::exception&) { Rows.clear(); break; }
+  }
+  if(Rows.size() != NPar+1 || Rows.at(0).size() != NPar)
+  {
+    std::cerr << "NESTModel::BasicModel::LoadWarmStart(): " << Model << "Log.txt is missing or doesn't have " << NPar << " parameters, so " << ModelType << ID << " starts from P." << std::endl;
+    return false;
+  }
+  InitialVect = Rows.at(0);
+  for(unsigned int i(0); i < NPar; ++i)
+  {
+    double Variance(Rows.at(i+1).size() == NPar ? Rows.at(i+1).at(i) : 0);
+    if(Variance > 0 && std::isfinite(Variance)) StepVect.at(i) = std::sqrt(Variance);
+  }
+  return true;
+}
+
+std::shared_ptr<const DataObject> NESTModel::BasicModel::LoadData(std::shared_ptr<SettingsObject> settings, std::string modeltype, unsigned int id, std::map<std::string, RecipeResult> recipes)
+{
+  bool Found(false);
+  FunctionObject FuncObj(settings->Query("FunctionDefinitions"), modeltype, id, Found); //The sets and recipes are shared by every ID of a ModelType.
+  std::shared_ptr<const DataObject> LoadedData;
+  if(Found) LoadedData.reset(new DataObject(FuncObj.GetSets(), FuncObj.GetRecipes(), std::stod(settings->Query("DefaultYieldUncertainty")), std::stod(settings->Query("DefaultEnergyUncertainty")), std::stod(settings->Query("DefaultEnergyUncertainty")), std::stod(settings->Query("LowField")), settings->Query("FunctionDefinitions"), settings->Query("CompileFormulas") == "true" ? settings->Query("FormulaCache") : "", settings->Query("FormulaCompiler"), recipes, settings->Query("DataCache") == "true"));
+  else std::cerr << "NESTModel::BasicModel::LoadData(): A proper model was not found in definitions file." << std::endl;
+  return LoadedData;
+}
+
 double NESTModel::BasicModel::operator()(double* x, double* p)
 {
   double CalculatedValue(0); //Default calculated value.
@@ -148,36 +258,177 @@ double NESTModel::BasicModel::DerivativeY(double* x, double* p)
   //return 0;
 }
 
+void NESTModel::BasicModel::Evaluate(const double* X, const double* Y, const double* p, double* Out, unsigned int N)
+{
+  //Same values as operator() for each (X[i], Y[i]), but vectorized when the model function could be compiled.
+  if(CanVectorize()) RunChunks(N, [this, X, Y, p, Out](unsigned int, unsigned int Begin, unsigned int End, double* Workspace) { Expression->Evaluate(X+Begin, Y+Begin, p, Out+Begin, End-Begin, Workspace); });
+  else if(Compiled && (!Is2DFit || DefaultField == -1)) RunChunks(N, [this, X, Y, p, Out](unsigned int, unsigned int Begin, unsigned int End, double*) { Compiled->Evaluate(X+Begin, Y+Begin, p, Out+Begin, End-Begin); });
+  else //TF1/TF2 evaluation is not reentrant, so it stays on this thread.
+  {
+    double xData[2];
+    double* par(const_cast<double*>(p)); //operator() keeps the TF1 functor signature, but never modifies the parameters.
+    for(unsigned int i(0); i < N; ++i)
+    {
+      xData[0] = X[i];
+      xData[1] = Y[i];
+      Out[i] = (*this)(xData, par);
+    }
+  }
+}
+
+double NESTModel::BasicModel::Objective(const double* p)
+{
+  return UseCovariance ? Chi2Covariance(p) : Chi2(p);
+}
+
+double NESTModel::BasicModel::Chi2(const double* p)
+{
+  //Effective variance chi-square: the errors in x and y are propagated through the slopes of the model.
+  //The value and both slopes come from one pass over the compiled model function when possible, and
+  //otherwise (or where that overflows) from 5-point stencils.
+  double Difference(0);
+  double Error(0);
+  double xData[2];
+  double* par(const_cast<double*>(p)); //operator() keeps the TF1 functor signature, but never modifies the parameters.
+  const double* DataX(Data->GetDataX().data());
+  const double* DataXErrLow(Data->GetDataXErrLow().data());
+  const double* DataXErrHigh(Data->GetDataXErrHigh().data());
+  const double* DataY(Data->GetDataY().data());
+  const double* DataYErrLow(Data->GetDataYErrLow().data());
+  const double* DataYErrHigh(Data->GetDataYErrHigh().data());
+  const double* DataZ(Data->GetDataZ().data());
+  const double* DataZErrLow(Data->GetDataZErrLow().data());
+  const double* DataZErrHigh(Data->GetDataZErrHigh().data());
+  double* Value(Residuals.data());
+  double* SlopeX(Solved.data());
+  double* SlopeY(Weights.data());
+  bool Fused(CanVectorize());
+  if(Fused) RunChunks(NData, [this, DataX, DataY, p, Value, SlopeX, SlopeY](unsigned int, unsigned int Begin, unsigned int End, double* Workspace) { Expression->EvaluateWithDerivatives(DataX+Begin, DataY+Begin, p, Value+Begin, SlopeX+Begin, SlopeY+Begin, End-Begin, Workspace); });
+  double XError, YError;
+  for(unsigned int datum(0); datum < NData; ++datum)
+  {
+    xData[0] = DataX[datum];
+    xData[1] = DataY[datum];
+    if(!Fused) Value[datum] = (*this)(xData, par);
+    if(!Fused || !std::isfinite(SlopeX[datum])) SlopeX[datum] = DerivativeX(xData,par);
+    if(!Fused || !std::isfinite(SlopeY[datum])) SlopeY[datum] = DerivativeY(xData,par);
+    Difference = DataZ[datum] - Value[datum];
+
+    if(Difference < 0) Error += DataZErrHigh[datum]*DataZErrHigh[datum]; //Add the higher error in the measurement if we estimated high.
+    else Error += DataZErrLow[datum]*DataZErrLow[datum]; //Add the lower error in the measurment if we estimated low.
+    XError = 0.5*(DataXErrLow[datum] + DataXErrHigh[datum])*SlopeX[datum];
+    YError = 0.5*(DataYErrLow[datum] + DataYErrHigh[datum])*SlopeY[datum];
+    Error += XError*XError; //Add the error in the x independent variable.
+    Error += YError*YError; //Add the error in the y independent variable.
+    Value[datum] = Difference*Difference / Error; //The term is kept, and summed below.
+    Error = 0;
+  }
+  return PairwiseSum(0, NData, [Value](unsigned int i) { return Value[i]; });
+}
+
+double NESTModel::BasicModel::Chi2Covariance(const double* p)
+{
+  //Uses the preallocated workspace, so that an evaluation does no heap allocations.
+  const double* DataZ(Data->GetDataZ().data());
+  double* Difference(Residuals.data());
+  Evaluate(Data->GetDataX().data(), Data->GetDataY().data(), p, Difference, NData);
+  for(unsigned int i(0); i < NData; ++i) Difference[i] = DataZ[i] - Difference[i];
+  return Data->GetCovarianceFactor().Chi2(Difference, Solved.data(), Pool.get());
+}
+
+double NESTModel::BasicModel::Chi2Covariance(const double* p, double* Gradient)
+{
+  //chi-square = r^T*V^-1*r with r = z - f(p), so d(chi-square)/dp_k = -2*sum_i (V^-1*r)_i*df_i/dp_k.
+  //V does not depend on the parameters. Only valid if HasGradient(). Each chunk of the data points gets its
+  //own partial gradient, and those are summed in chunk order, so the result doesn't depend on FitThreads.
+  const double* DataX(Data->GetDataX().data());
+  const double* DataY(Data->GetDataY().data());
+  const double* DataZ(Data->GetDataZ().data());
+  double* Difference(Residuals.data());
+  const double* V(Weights.data());
+  double* Partial(Partials.data());
+  unsigned int NChunks((NData + ChunkSize - 1)/ChunkSize);
+  RunChunks(NData, [this, DataX, DataY, DataZ, p, Difference](unsigned int, unsigned int Begin, unsigned int End, double* Workspace)
+	    {
+	      Expression->Evaluate(DataX+Begin, DataY+Begin, p, Difference+Begin, End-Begin, Workspace);
+	      for(unsigned int i(Begin); i < End; ++i) Difference[i] = DataZ[i] - Difference[i];
+	    });
+  double Result(Data->GetCovarianceFactor().Chi2(Difference, Solved.data(), Weights.data(), Pool.get()));
+  RunChunks(NData, [this, DataX, DataY, p, V, Partial](unsigned int Chunk, unsigned int Begin, unsigned int End, double* Workspace) { Expression->WeightedGradient(DataX+Begin, DataY+Begin, p, V+Begin, Partial+Chunk*NPar, End-Begin, Workspace); });
+  for(unsigned int k(0); k < NPar; ++k) Gradient[k] = -2*PairwiseSum(0, NChunks, [this, Partial, k](unsigned int Chunk) { return Partial[Chunk*NPar+k]; });
+  for(unsigned int k(0); k < NPar; ++k) if(!std::isfinite(Gradient[k]) && std::isfinite(Result)) //Overflowed intermediate (e.g. a large power), so use a central difference instead.
+  {
+    std::vector<double> Shifted(p, p+NPar);
+    double h(1e-6*(std::fabs(p[k]) + StepVect.at(k)));
+    Shifted[k] = p[k] + h;
+    double Up(Chi2Covariance(Shifted.data()));
+    Shifted[k] = p[k] - h;
+    Gradient[k] = (Up - Chi2Covariance(Shifted.data()))/(2*h);
+  }
+  return Result;
+}
+
+bool NESTModel::BasicModel::HasGradient()
+{
+  return UseCovariance && CanVectorize(); //The effective variance would need the mixed second derivatives.
+}
+
+bool NESTModel::BasicModel::CanVectorize()
+{
+  return Expression && (!Is2DFit || DefaultField == -1); //The compiled function takes y from the data, not from DefaultField.
+}
+
+void NESTModel::BasicModel::RunChunks(unsigned int N, const std::function<void(unsigned int Chunk, unsigned int Begin, unsigned int End, double* Workspace)>& Body)
+{
+  //Splits [0, N) into chunks of ChunkSize points. The chunks never depend on the number of threads, and each
+  //writes only its own outputs, so the results are the same whether they run here or on the pool.
+  unsigned int NChunks((N + ChunkSize - 1)/ChunkSize);
+  double* Workspace(ExpressionWorkspaces.empty() ? nullptr : ExpressionWorkspaces.at(0).data());
+  if(!Pool || NChunks < 2)
+  {
+    for(unsigned int Chunk(0); Chunk < NChunks; ++Chunk) Body(Chunk, Chunk*ChunkSize, std::min(N, (Chunk+1)*ChunkSize), Workspace);
+    return;
+  }
+  unsigned int NTasks(std::min(NChunks, Pool->GetNThreads()));
+  std::vector< std::future<void> > Done;
+  for(unsigned int Task(0); Task < NTasks; ++Task)
+  {
+    Workspace = ExpressionWorkspaces.empty() ? nullptr : ExpressionWorkspaces.at(Task).data(); //Each task has its own workspace.
+    Done.push_back(Pool->Submit([&Body, N, NChunks, NTasks, Task, Workspace]()
+				{
+				  for(unsigned int Chunk(Task); Chunk < NChunks; Chunk += NTasks) Body(Chunk, Chunk*ChunkSize, std::min(N, (Chunk+1)*ChunkSize), Workspace);
+				}));
+  }
+  for(unsigned int Task(0); Task < Done.size(); ++Task) Done.at(Task).get();
+}
+
 bool NESTModel::BasicModel::Minimize()
 {
   if(Success)
   {
-    MinuitMinimizer->SetPrintLevel(stoi(Settings->Query("Verbosity"))); //Set how loud the minimizer will be. 0 is normal, -1 low, and 1 high.
-    MinuitMinimizer->SetFCN(NESTModel::Chi2Covariance); //Set the function to be minimized.
-    double arglist[5]; //Create an array for possible arguments.
-    int ierflg(0); //Error flag. Modified by minuit commands.
-    arglist[0] = std::stod(Settings->Query("UP")); //Load the value of UP.
-    MinuitMinimizer->mnexcm("SET ERR", arglist, 1, ierflg); //Set UP.
-    for(unsigned int i(0); i < NPar; ++i) MinuitMinimizer->mnparm(i, std::string("a"+std::to_string(i)).c_str(), InitialVect.at(i), StepVect.at(i), LimitsLow.at(i), LimitsHigh.at(i), ierflg); //Set initial parameters, step sizes, and limits in the minimizer.
-    arglist[0] = std::stoi(Settings->Query("MaxCalls")); //Maximum number of calls.
-    arglist[1] = std::stoi(Settings->Query("Tolerance")); //Tolerance. Stops when EDM < 0.01*[Tolerance]*UP.
-    MinuitMinimizer->mnexcm(Settings->Query("Algorithm").c_str(), arglist, 2, ierflg); //Execute minimization.
-    if(ierflg == 0)
+    std::shared_ptr<FitCacheObject> Cache;
+    if(Settings->Query("FitCache") != "")
     {
-      double Parameter, ParameterError;
-      for(unsigned int i(0); i < NPar; ++i) //If successful, retrieve fit parameters and their error.
+      Cache.reset(new FitCacheObject(Settings->Query("FitCache"), CacheKey()));
+      FromCache = Cache->Load(Chisquare, EDM, NFree, Parameters, ParameterErrors, Covariance) && Parameters.size() == NPar;
+      if(FromCache)
       {
-	if(Settings->Query("Hesse") == "true") MinuitMinimizer->mnexcm("HESSE", arglist, 2, ierflg);
-	MinuitMinimizer->GetParameter(i, Parameter, ParameterError);
-	Parameters.push_back(Parameter);
-	ParameterErrors.push_back(ParameterError);
+	Converged = true; //Only converged fits are cached.
+	FitTime = 0;
+	Status = 0;
+	RecordFit();
+	return true;
       }
-      double ErrDef;
-      int NParI, NParX, IStat;
-      MinuitMinimizer->mnstat(Chisquare, EDM, ErrDef, NParI, NParX, IStat); //Store chisquare and EDM of fit.
     }
-    else std::cerr << "The minimizer threw a flag. This is most likely a convergence issue, but this can be confirmed by setting the verbosity to > 0." << std::endl;
-    return (ierflg == 0) ? true : false; //Return success based on ierflg.
+    std::chrono::steady_clock::time_point Start(std::chrono::steady_clock::now());
+    unsigned int RequestedStarts(std::stoi(Settings->Query("MultiStarts")));
+    //With several starts, the final minimization starts from the best of them, so it only has to refine it.
+    Converged = RunMinimizer(RequestedStarts > 1 ? MultiStart(RequestedStarts) : InitialVect, std::stoi(Settings->Query("MaxCalls")), Settings->Query("Hesse") == "true");
+    if(Converged && Cache && !Cache->Save(Chisquare, EDM, NFree, Parameters, ParameterErrors, Covariance)) std::cerr << "NESTModel::BasicModel::Minimize(): Could not write " << Cache->GetFileName() << "." << std::endl;
+    if(!Converged) std::cerr << "The minimizer threw a flag. This is most likely a convergence issue, but this can be confirmed by setting the verbosity to > 0." << std::endl;
+    FitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count(); //Wall time of the minimization in seconds.
+    RecordFit();
+    return Converged;
   }
   else
   {
@@ -186,14 +437,326 @@ bool NESTModel::BasicModel::Minimize()
   }
 }
 
+bool NESTModel::BasicModel::Minimize(const std::vector<double>& Start)
+{
+  //Single minimization from Start instead of P, e.g. warm started from the fit of related data.
+  if(!Success || Start.size() != NPar)
+  {
+    std::cerr << "NESTModel::BasicModel::Minimize(): Can't initialize minimizer. Invalid definition or starting point." << std::endl;
+    return false;
+  }
+  std::chrono::steady_clock::time_point Begin(std::chrono::steady_clock::now());
+  Converged = RunMinimizer(Start, std::stoi(Settings->Query("MaxCalls")), Settings->Query("Hesse") == "true");
+  FitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+  return Converged;
+}
+
+bool NESTModel::BasicModel::Minimize(const std::vector<double>& Start, const std::vector<unsigned int>& Fixed)
+{
+  //Same, but the parameters listed in Fixed are held at their value in Start, e.g. to profile the chi-square.
+  if(!Success || Start.size() != NPar)
+  {
+    std::cerr << "NESTModel::BasicModel::Minimize(): Can't initialize minimizer. Invalid definition or starting point." << std::endl;
+    return false;
+  }
+  std::chrono::steady_clock::time_point Begin(std::chrono::steady_clock::now());
+  Converged = RunMinimizer(Start, std::stoi(Settings->Query("MaxCalls")), false, Fixed);
+  FitTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Begin).count();
+  return Converged;
+}
+
+bool NESTModel::BasicModel::RunMinimizer(const std::vector<double>& Start, unsigned int MaxCalls, bool Hesse, const std::vector<unsigned int>& Fixed)
+{
+  Minimizer->Clear(); //Forget the variables of an earlier run.
+  Minimizer->SetPrintLevel(stoi(Settings->Query("Verbosity"))); //Set how loud the minimizer will be. 0 is normal, -1 low, and 1 high.
+  if(Settings->Query("AnalyticGradient") == "true" && HasGradient()) Minimizer->SetFunction(*GradFCN); //Set the function to be minimized, with its exact gradient.
+  else Minimizer->SetFunction(*FCN); //Set the function to be minimized. The gradient is estimated by Minuit.
+  Minimizer->SetErrorDef(std::stod(Settings->Query("UP"))); //Set UP.
+  for(unsigned int i(0); i < NPar; ++i) //Set initial parameters, step sizes, and limits in the minimizer.
+  {
+    //Zeroes for both limits mean that the parameter is unrestricted.
+    if(std::find(Fixed.begin(), Fixed.end(), i) != Fixed.end()) Minimizer->SetFixedVariable(i, "a"+std::to_string(i), Start.at(i));
+    else if(LimitsLow.at(i) == 0 && LimitsHigh.at(i) == 0) Minimizer->SetVariable(i, "a"+std::to_string(i), Start.at(i), StepVect.at(i));
+    else Minimizer->SetLimitedVariable(i, "a"+std::to_string(i), Start.at(i), StepVect.at(i), LimitsLow.at(i), LimitsHigh.at(i));
+  }
+  Minimizer->SetMaxFunctionCalls(MaxCalls); //Maximum number of calls.
+  Minimizer->SetMaxIterations(MaxCalls);
+  Minimizer->SetTolerance(std::stod(Settings->Query("Tolerance"))); //Tolerance. Stops when EDM < 0.002*[Tolerance]*UP.
+  bool Result(Minimizer->Minimize()); //Execute minimization.
+  if(Result)
+  {
+    if(Hesse) Minimizer->Hesse();
+    Parameters.clear();
+    ParameterErrors.clear();
+    for(unsigned int i(0); i < NPar; ++i) //If successful, retrieve fit parameters and their error.
+    {
+      Parameters.push_back(Minimizer->X()[i]);
+      ParameterErrors.push_back(Minimizer->Errors()[i]);
+    }
+    Chisquare = Minimizer->MinValue(); //Store chisquare and EDM of fit.
+    EDM = Minimizer->Edm();
+    NFree = Minimizer->NFree();
+    Covariance.assign(NPar*NPar, 0);
+    for(unsigned int i(0); i < NPar; ++i) for(unsigned int j(0); j < NPar; ++j) Covariance.at(i*NPar+j) = Minimizer->CovMatrix(i,j);
+  }
+  Status = Minimizer->Status();
+  return Result;
+}
+
+void NESTModel::BasicModel::HashData(HashObject& Hash)
+{
+  //The data sets, their bytes and the recipes applied to them.
+  for(unsigned int set(0); set < Sets.size(); ++set)
+  {
+    Hash.Add(Sets.at(set));
+    Hash.AddFile(Sets.at(set) + ".csv");
+    std::string Recipe(set < Recipes.size() ? Recipes.at(set) : ".");
+    Hash.Add(Recipe);
+    if(Recipe.find(".") == std::string::npos && Recipe.size() > 1) //Same convention as DataObject: the last character is the ModelID.
+    {
+      bool Found(false);
+      FunctionObject RecipeFunction(Settings->Query("FunctionDefinitions"), Recipe.substr(0, Recipe.size()-1), std::stoi(Recipe.substr(Recipe.size()-1, 1)), Found);
+      if(Found) Hash.Add(RecipeFunction.GetFunction());
+      Hash.AddFile(Recipe + "Log.txt");
+    }
+  }
+}
+
+std::string NESTModel::BasicModel::DataKey()
+{
+  //Identifies the data a fit was made to, including the settings DataObject fills in missing uncertainties with.
+  HashObject Hash;
+  HashData(Hash);
+  const char* Keys[] = {"DefaultYieldUncertainty", "DefaultEnergyUncertainty", "LowField"};
+  for(unsigned int k(0); k < sizeof(Keys)/sizeof(Keys[0]); ++k) Hash.Add(std::string(Keys[k]) + ":" + Settings->Query(Keys[k]));
+  return Hash.GetHex();
+}
+
+void NESTModel::BasicModel::RecordFit()
+{
+  //Outputs of every nominal fit, whether it converged or not.
+  if(Settings->Query("FitResults") == "true") SaveFitResult();
+  if(Settings->Query("FitStore") != "") StoreFit();
+}
+
+bool NESTModel::BasicModel::StoreFit()
+{
+  FitStoreObject::Record Entry;
+  HashObject Formula;
+  Formula.Add(FuncObject->GetFunction());
+  Entry.ModelType = ModelType;
+  Entry.ModelID = ID;
+  Entry.FormulaHash = Formula.Get();
+  Entry.DataHash = std::stoull(DataKey(), nullptr, 16);
+  Entry.Chisquare = Chisquare;
+  Entry.EDM = EDM;
+  Entry.Status = Status;
+  Entry.NFree = NFree;
+  Entry.NData = NData;
+  Entry.Converged = Converged;
+  Entry.FromCache = FromCache;
+  Entry.NCalls = GetNCalls();
+  Entry.FitTime = FitTime;
+  Entry.Parameters = Parameters;
+  Entry.Errors = ParameterErrors;
+  Entry.Covariance = Covariance;
+  if(Entry.Parameters.size() != NPar || Entry.Errors.size() != NPar || Entry.Covariance.size() != NPar*NPar) //Never minimized successfully.
+  {
+    Entry.Parameters.assign(NPar, std::nan(""));
+    Entry.Errors.assign(NPar, std::nan(""));
+    Entry.Covariance.assign(NPar*NPar, std::nan(""));
+  }
+  return FitStoreObject(Settings->Query("FitStore")).Append(Entry);
+}
+
+bool NESTModel::BasicModel::SaveFitResult()
+{
+  FitResultObject Result;
+  std::string SetList, RecipeList;
+  for(unsigned int set(0); set < Sets.size(); ++set) SetList += (set ? "," : "") + Sets.at(set);
+  for(unsigned int set(0); set < Recipes.size(); ++set) RecipeList += (set ? "," : "") + Recipes.at(set);
+  Result.Set("ModelType", ModelType);
+  Result.Set("ModelID", std::to_string(ID));
+  Result.Set("Function", FuncObject->GetFunction());
+  Result.Set("Converged", Converged ? "true" : "false");
+  Result.Set("Chisquare", Chisquare);
+  Result.Set("NFree", NFree);
+  Result.Set("NData", NData);
+  Result.Set("EDM", EDM);
+  Result.Set("NCalls", GetNCalls());
+  Result.Set("FitTime", FitTime);
+  Result.Set("Status", Status);
+  Result.Set("Parameters", Parameters);
+  Result.Set("Errors", ParameterErrors);
+  Result.Set("Covariance", Covariance); //Row by row.
+  Result.Set("Definitions", Settings->Query("FunctionDefinitions"));
+  Result.Set("Sets", SetList);
+  Result.Set("Recipes", RecipeList);
+  Result.Set("DefaultYieldUncertainty", Settings->Query("DefaultYieldUncertainty"));
+  Result.Set("DefaultEnergyUncertainty", Settings->Query("DefaultEnergyUncertainty"));
+  Result.Set("LowField", Settings->Query("LowField"));
+  Result.Set("DataKey", DataKey());
+  std::string FileName(ModelType + std::to_string(ID) + "Fit.txt");
+  if(Result.Save(FileName))
+  {
+    FitResultFile = FileName;
+    FitResultDataChanged = false;
+    return true;
+  }
+  std::cerr << "NESTModel::BasicModel::SaveFitResult(): Could not write " << FileName << "." << std::endl;
+  return false;
+}
+
+bool NESTModel::BasicModel::LoadFitResult(std::string FileName, bool AllowDataChange)
+{
+  //Takes the result of an earlier fit of this model instead of minimizing, e.g. to draw its plots. The model
+  //has to use the data sets and recipes of the fit, and unless AllowDataChange is set, the same data.
+  FitResultObject Result;
+  if(!Success || !Result.Load(FileName)) return false;
+  if(Result.Get("ModelType") != ModelType || Result.Get("ModelID") != std::to_string(ID))
+  {
+    std::cerr << "NESTModel::BasicModel::LoadFitResult(): " << FileName << " is a fit of " << Result.Get("ModelType") << Result.Get("ModelID") << ", not of " << ModelType << ID << "." << std::endl;
+    return false;
+  }
+  if(Result.Get("Function") != FuncObject->GetFunction())
+  {
+    std::cerr << "NESTModel::BasicModel::LoadFitResult(): The function of " << ModelType << ID << " was changed in the definitions file since " << FileName << " was written." << std::endl;
+    return false;
+  }
+  std::vector<double> LoadedParameters(Result.GetNumbers("Parameters")), LoadedErrors(Result.GetNumbers("Errors")), LoadedCovariance(Result.GetNumbers("Covariance"));
+  if(LoadedParameters.size() != NPar || LoadedErrors.size() != NPar || LoadedCovariance.size() != NPar*NPar)
+  {
+    std::cerr << "NESTModel::BasicModel::LoadFitResult(): " << FileName << " doesn't have " << NPar << " parameters with their errors and covariance." << std::endl;
+    return false;
+  }
+  std::string SetList, RecipeList;
+  for(unsigned int set(0); set < Sets.size(); ++set) SetList += (set ? "," : "") + Sets.at(set);
+  for(unsigned int set(0); set < Recipes.size(); ++set) RecipeList += (set ? "," : "") + Recipes.at(set);
+  if(Result.Get("Sets") != SetList || Result.Get("Recipes") != RecipeList)
+  {
+    std::cerr << "NESTModel::BasicModel::LoadFitResult(): " << FileName << " is a fit to the sets \"" << Result.Get("Sets") << "\" with the recipes \"" << Result.Get("Recipes") << "\", not to \"" << SetList << "\" with \"" << RecipeList << "\"." << std::endl;
+    return false;
+  }
+  bool DataChanged(Result.Get("DataKey") != DataKey());
+  if(DataChanged)
+  {
+    std::cerr << "NESTModel::BasicModel::LoadFitResult(): " << (AllowDataChange ? "Warning, the" : "The") << " data of " << ModelType << ID << " changed since " << FileName << " was written." << (AllowDataChange ? " The current data is used." : "") << std::endl;
+    if(!AllowDataChange) return false;
+  }
+  Parameters = LoadedParameters;
+  ParameterErrors = LoadedErrors;
+  Covariance = LoadedCovariance;
+  Chisquare = Result.GetNumber("Chisquare");
+  EDM = Result.GetNumber("EDM");
+  NFree = Result.GetNumber("NFree");
+  FitTime = Result.GetNumber("FitTime");
+  Status = Result.Has("Status") ? Result.GetNumber("Status") : -1;
+  Converged = Result.Get("Converged") == "true";
+  FitResultFile = FileName;
+  FitResultDataChanged = DataChanged;
+  return true;
+}
+
+std::string NESTModel::BasicModel::CacheKey()
+{
+  //Everything the result of Minimize() depends on: the model, the bytes of its data sets, the recipes applied
+  //to them, the settings used by the data and the minimizer, and how the formula is evaluated (a compiled
+  //formula is evaluated differently than TFormula). Plotting and output settings are left out.
+  HashObject Hash;
+  Hash.Add(std::string("MinuitFit fit cache 1")); //To be changed along with the way fits are computed.
+  Hash.Add(FuncObject->GetFunction());
+  Hash.Add(InitialVect);
+  Hash.Add(LimitsLow);
+  Hash.Add(LimitsHigh);
+  Hash.Add(StepVect);
+  HashData(Hash);
+  const char* Keys[] = {"Tolerance", "UP", "MaxCalls", "Algorithm", "Hesse", "Chi2", "AnalyticGradient", "MultiStarts", "MultiStartWidth", "MultiStartSeed", "MultiStartPruneCalls", "MultiStartPrune", "DefaultYieldUncertainty", "DefaultEnergyUncertainty", "LowField", "CompileFormulas", "FormulaCompiler"};
+  for(unsigned int k(0); k < sizeof(Keys)/sizeof(Keys[0]); ++k) Hash.Add(std::string(Keys[k]) + ":" + Settings->Query(Keys[k]));
+  return ModelType + std::to_string(ID) + "_" + Hash.GetHex();
+}
+
+std::vector<double> NESTModel::BasicModel::MultiStart(unsigned int RequestedStarts)
+{
+  //Every start is minimized by its own BasicModel (sharing the settings and data), so that they can run
+  //concurrently. They first get only MultiStartPruneCalls calls; the starts whose chi-square is then more
+  //than MultiStartPrune times the best one are dropped, and the others continue with the full MaxCalls.
+  std::vector< std::vector<double> > Starts(SampleStarts(RequestedStarts));
+  std::vector< std::shared_ptr<BasicModel> > Runs;
+  for(unsigned int s(0); s < RequestedStarts; ++s) Runs.push_back(std::shared_ptr<BasicModel>(new BasicModel(ModelType, ID, Settings, Data)));
+  std::vector<double> Chi2s(RequestedStarts, std::numeric_limits<double>::infinity());
+  std::vector<bool> Finished(RequestedStarts, false);
+  unsigned int MaxCalls(std::stoi(Settings->Query("MaxCalls")));
+  unsigned int PruneCalls(std::min<unsigned int>(MaxCalls, std::stoi(Settings->Query("MultiStartPruneCalls"))));
+  double Prune(std::stod(Settings->Query("MultiStartPrune")));
+  double Best(std::numeric_limits<double>::infinity());
+  {
+    ThreadPool StartPool(std::stoi(Settings->Query("MultiStartThreads")));
+    for(unsigned int Stage(0); Stage < 2; ++Stage)
+    {
+      std::vector< std::future<bool> > Done(RequestedStarts);
+      for(unsigned int s(0); s < RequestedStarts; ++s)
+      {
+	if(Finished.at(s) || (Stage == 1 && !(Chi2s.at(s) <= Prune*Best))) continue; //Converged already, or pruned.
+	std::shared_ptr<BasicModel> Run(Runs.at(s));
+	std::vector<double> From(Stage == 0 ? Starts.at(s) : std::vector<double>(Run->Minimizer->X(), Run->Minimizer->X() + NPar));
+	unsigned int Calls(Stage == 0 ? PruneCalls : MaxCalls);
+	Done.at(s) = StartPool.Submit([Run, From, Calls]() { return Run->RunMinimizer(From, Calls, false); });
+      }
+      for(unsigned int s(0); s < RequestedStarts; ++s)
+      {
+	if(!Done.at(s).valid()) continue;
+	Finished.at(s) = Done.at(s).get();
+	Chi2s.at(s) = Runs.at(s)->Minimizer->MinValue();
+	if(std::isfinite(Chi2s.at(s))) Best = std::min(Best, Chi2s.at(s));
+      }
+    }
+  }
+
+  //Keep the best converged start, or the best of all if none converged.
+  BestStart = 0;
+  for(unsigned int s(1); s < RequestedStarts; ++s)
+  {
+    if(Finished.at(s) != Finished.at(BestStart) ? Finished.at(s) : Chi2s.at(s) < Chi2s.at(BestStart)) BestStart = s;
+  }
+  StartCalls = 0;
+  for(unsigned int s(0); s < RequestedStarts; ++s) StartCalls += Runs.at(s)->GetNCalls();
+  NStarts = RequestedStarts;
+  if(!std::isfinite(Chi2s.at(BestStart))) return InitialVect;
+  return std::vector<double>(Runs.at(BestStart)->Minimizer->X(), Runs.at(BestStart)->Minimizer->X() + NPar);
+}
+
+std::vector< std::vector<double> > NESTModel::BasicModel::SampleStarts(unsigned int RequestedStarts)
+{
+  //The first start is P itself. The others are a Latin hypercube sample: each parameter's range is split
+  //into RequestedStarts-1 strata, and every stratum is used by exactly one start. The range is [LL, LH]
+  //when the parameter is limited, and P +/- MultiStartWidth*(|P| + step size) otherwise.
+  std::vector< std::vector<double> > Starts(RequestedStarts, InitialVect);
+  unsigned int NSampled(RequestedStarts - 1);
+  std::mt19937_64 Generator(std::stoull(Settings->Query("MultiStartSeed"))); //Fixed seed, so the starts are reproducible.
+  std::uniform_real_distribution<double> Uniform(0, 1);
+  double Width(std::stod(Settings->Query("MultiStartWidth")));
+  std::vector<unsigned int> Strata(NSampled);
+  for(unsigned int i(0); i < NPar; ++i)
+  {
+    double Low(LimitsLow.at(i)), High(LimitsHigh.at(i));
+    if(Low == 0 && High == 0)
+    {
+      Low = InitialVect.at(i) - Width*(std::fabs(InitialVect.at(i)) + StepVect.at(i));
+      High = InitialVect.at(i) + Width*(std::fabs(InitialVect.at(i)) + StepVect.at(i));
+    }
+    for(unsigned int s(0); s < NSampled; ++s) Strata.at(s) = s;
+    std::shuffle(Strata.begin(), Strata.end(), Generator);
+    for(unsigned int s(0); s < NSampled; ++s) Starts.at(s+1).at(i) = Low + (High - Low)*(Strata.at(s) + Uniform(Generator))/NSampled;
+  }
+  return Starts;
+}
+
 void NESTModel::BasicModel::PrintResults()
 {
   if(Success)
   {
-    double MinChi2, EDM, ErrDef, CovMatrix[NPar][NPar];
-    int NParI, NParX, IStat;
-    MinuitMinimizer->mnstat(MinChi2, EDM, ErrDef, NParI, NParX, IStat);
-    MinuitMinimizer->mnemat(&CovMatrix[0][0],NPar);
+    double MinChi2(Chisquare);
+    int NParX(NFree);
     std::ofstream OutputFile(static_cast<std::stringstream&>(std::stringstream("").flush() << "FitResults_" << ModelType << ID << ".txt").str().c_str());
     std::streambuf *coutBuf;
     if(Settings->Query("ResultsToFile") == "true")
@@ -205,6 +768,8 @@ void NESTModel::BasicModel::PrintResults()
     std::cout << "ModelType: " << ModelType << std::endl;
     std::cout << "ModelID: " << ID << std::endl;
     std::cout << "ModelString: " << FuncObject->GetFunction() << std::endl;
+    if(FromCache) std::cout << "Loaded from the fit cache" << std::endl;
+    if(NStarts > 1) std::cout << "Starts: " << NStarts << " (best from start " << BestStart << ")" << std::endl;
     std::cout << "Minimum Chi^2: " << MinChi2 << std::endl;
     std::cout << "Reduced Chi^2: " << MinChi2/(NData-NParX) << std::endl;
     std::cout << "PARAMETERS" << std::endl;
@@ -221,7 +786,7 @@ void NESTModel::BasicModel::PrintResults()
       {
 	std::cout << "Correlation between parameter " << i << " and " << j << ": "
 		  << std::setprecision(3)
-		  << CovMatrix[i][j]/(ParameterErrors.at(i) * ParameterErrors.at(j))
+		  << Covariance.at(i*NPar+j)/(ParameterErrors.at(i) * ParameterErrors.at(j))
 		  << std::endl;
       }
     }
@@ -234,15 +799,14 @@ void NESTModel::BasicModel::PrintResults()
 
 void NESTModel::BasicModel::SaveParameters()
 {
-  double CovMatrix[NPar][NPar];
-  MinuitMinimizer->mnemat(&CovMatrix[0][0], NPar);
   std::ofstream OutputFile(static_cast<std::stringstream&>(std::stringstream("").flush()  << ModelType << ID << "Log.txt").str().c_str());
+  OutputFile << std::setprecision(std::numeric_limits<double>::max_digits10); //Read back exactly when used as a recipe or warm start.
   for(unsigned int i(0); i < Parameters.size()-1; ++i) OutputFile << Parameters.at(i) << ",";
   OutputFile << Parameters.back() << std::endl;
   for(unsigned int i(0); i < Parameters.size(); ++i)
   {
-    for(unsigned int j(0); j < Parameters.size()-1; ++j) OutputFile << CovMatrix[i][j] << ",";
-    OutputFile << CovMatrix[i][Parameters.size()-1] << std::endl;
+    for(unsigned int j(0); j < Parameters.size()-1; ++j) OutputFile << Covariance.at(i*NPar+j) << ",";
+    OutputFile << Covariance.at(i*NPar+Parameters.size()-1) << std::endl;
   }
   OutputFile.close();
 }
@@ -265,7 +829,7 @@ void NESTModel::BasicModel::DrawGraphs()
   bool ROOTV604(Settings->Query("ROOTV6.04") == "true" ? true : false);
   bool LogX(Settings->Query("LogX") == "true" ? true : false);
   bool LogY(Settings->Query("LogY") == "true" ? true : false);
-  bool OutputToFile(Settings->Query("OutputToFile") == "true" ? true : false);
+  bool OutputToFile(Settings->Query("OutputToFile") == "true" && !PlotWorker ? true : false); //Written by the parent of a plotting worker.
   bool DrawPave(Settings->Query("DrawPave") == "true" ? true : false);
   bool PlotBins(Settings->Query("PlotBins") == "true" ? true : false);
   unsigned int PaletteEnumOld(stoi(Settings->Query("Palette")));
@@ -274,6 +838,13 @@ void NESTModel::BasicModel::DrawGraphs()
   unsigned int MarkerSize(stoi(Settings->Query("MarkerSize")));
   unsigned int LineStyle(stoi(Settings->Query("LineStyle")));
   unsigned int LineSize(stoi(Settings->Query("LineSize")));
+  const std::vector<double>& DataX(Data->GetDataX());
+  const std::vector<double>& DataXErrLow(Data->GetDataXErrLow());
+  const std::vector<double>& DataXErrHigh(Data->GetDataXErrHigh());
+  const std::vector<double>& DataY(Data->GetDataY());
+  const std::vector<double>& DataZ(Data->GetDataZ());
+  const std::vector<double>& DataZErrLow(Data->GetDataZErrLow());
+  const std::vector<double>& DataZErrHigh(Data->GetDataZErrHigh());
 
   if(Is2DFit)
   {
@@ -319,15 +890,14 @@ void NESTModel::BasicModel::DrawGraphs()
       }
     }
     const unsigned int MapSize(Map.size()); //Need to create this many separate graphs.
-    TGraphAsymmErrors* GraphArray[MapSize]; //Create the array that will hold these graphs.
-    TF1* FunctionArray[MapSize]; //Create the array that will hold the functions to draw.
+    std::vector<TGraphAsymmErrors*> GraphArray(MapSize); //Create the array that will hold these graphs.
+    std::vector<TF1*> FunctionArray(MapSize); //Create the array that will hold the functions to draw.
     const unsigned int MaxPoints(NData); //At most, we have this many points for a given field.
     double DataXArr[MaxPoints], DataXErrLowArr[MaxPoints], DataXErrHighArr[MaxPoints], DataZArr[MaxPoints], DataZErrLowArr[MaxPoints], DataZErrHighArr[MaxPoints]; //Arrays for handing off data to graph constructor.
     unsigned int FieldIndex(0); //Will need this later.
     double ParameterArr[NPar]; //Need to have parameters stored in an array so we can set the functions parameters.
     unsigned int ColorList[MapSize]; //Stores the color of each function.
     unsigned int TempColorID(0); //Stores the color index of a single field bin.
-    TCanvas* FieldCanvas;
     TMultiGraph* MultiGraph = new TMultiGraph(); //Create the multigraph object.
     MultiGraph->SetTitle(std::string(Title+";"+XTitle+";"+ZTitle).c_str());
     for(std::map<int, std::vector< std::vector<double> > >::iterator MapIterator = Map.begin(); MapIterator != Map.end(); ++MapIterator, ++FieldIndex)
@@ -357,19 +927,20 @@ void NESTModel::BasicModel::DrawGraphs()
       GraphArray[FieldIndex]->SetLineWidth(LineSize);
       GraphArray[FieldIndex]->SetLineStyle(LineStyle);
       MultiGraph->Add(GraphArray[FieldIndex]);
-
-      FieldCanvas = new TCanvas("FieldCanvas", "FieldCanvas", 1920, 1080);
       GraphArray[FieldIndex]->SetTitle(std::string(std::to_string(int((MapIterator->first)*FieldBinSize - YLow)) + " - " + std::string(std::to_string(int((MapIterator->first)*FieldBinSize + FieldBinSize - YLow))) +" V/cm;"+XTitle+";"+ZTitle).c_str());
       GraphArray[FieldIndex]->GetXaxis()->CenterTitle();
       GraphArray[FieldIndex]->GetYaxis()->CenterTitle();
-      GraphArray[FieldIndex]->GetXaxis()->SetLimits(XLow,XHigh);
-      GraphArray[FieldIndex]->GetYaxis()->SetRangeUser(ZLow,ZHigh);
-      GraphArray[FieldIndex]->Draw("AP");
-      FunctionArray[FieldIndex]->Draw("SAME");
-      if(PlotBins) FieldCanvas->SaveAs(static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << ID << "_Field" << std::setw(2) << std::setfill('0') << FieldIndex << PlotExtension.c_str()).str().c_str());
-      delete FieldCanvas;
-      
     }
+    //Plot of a single field bin. The canvases are only drawn once the model plot is done with the graphs.
+    auto DrawBin = [&](unsigned int Bin) -> TCanvas*
+    {
+      TCanvas* BinCanvas(new TCanvas(("FieldCanvas" + std::to_string(Bin)).c_str(), "FieldCanvas", 1920, 1080));
+      GraphArray[Bin]->GetXaxis()->SetLimits(XLow,XHigh);
+      GraphArray[Bin]->GetYaxis()->SetRangeUser(ZLow,ZHigh);
+      GraphArray[Bin]->Draw("AP");
+      FunctionArray[Bin]->Draw("SAME");
+      return BinCanvas;
+    };
     auto Canvas = new TCanvas("YieldCanvas", "YieldCanvas", 1920, 1080);
     if(LogX) Canvas->SetLogx();
     if(LogY) Canvas->SetLogy();
@@ -416,23 +987,37 @@ void NESTModel::BasicModel::DrawGraphs()
       MultiGraph->Write();
       for(unsigned int i(0); i < MapSize; ++i) FunctionArray[i]->Write();
     }
-    Canvas->SaveAs(static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << "_Model" << ID << PlotExtension.c_str()).str().c_str());
+    if(!PlotWorker) Canvas->SaveAs(static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << "_Model" << ID << PlotExtension.c_str()).str().c_str());
+    if(PlotBins && PlotExtension == ".pdf" && !PlotWorker) //One PDF with the model plot, then a page per field bin.
+    {
+      std::string MergedPDF = static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << ID << "Merged" << PlotExtension.c_str()).str();
+      Canvas->Print((MergedPDF + "[").c_str()); //Opens the file without drawing a page.
+      Canvas->Print(MergedPDF.c_str());
+      for(unsigned int i(0); i < MapSize; ++i)
+      {
+	TCanvas* BinCanvas(DrawBin(i));
+	BinCanvas->Print(MergedPDF.c_str());
+	delete BinCanvas;
+      }
+      Canvas->Print((MergedPDF + "]").c_str()); //Closes the file.
+    }
+    else if(PlotBins || PlotWorker) //An image per field bin, drawn by several processes.
+    {
+      auto SaveBin = [&](unsigned int Bin)
+	{
+	  TCanvas* BinCanvas(DrawBin(Bin));
+	  BinCanvas->SaveAs(static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << ID << "_Field" << std::setw(2) << std::setfill('0') << Bin << PlotExtension.c_str()).str().c_str());
+	  delete BinCanvas;
+	};
+      if(PlotWorker) for(unsigned int i(PlotBinFirst); i <= PlotBinLast && i < MapSize; ++i) SaveBin(i);
+      else PlotFieldBins(MapSize, SaveBin);
+    }
     delete Canvas;
     if(OutputToFile) delete OutputFile;
     delete MultiGraph;
     delete HistDummy;
     if(DrawPave) delete Pave;
     for(unsigned int i(0); i < MapSize; ++i) delete FunctionArray[i];
-
-    if(PlotExtension == ".pdf" && PlotBins)
-    {
-      std::string GlobalPDF = static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << "_Model" << ID << PlotExtension.c_str()).str();
-      std::string IndividualPDF = static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << ID << "_Field*" << PlotExtension.c_str()).str();
-      std::string NewPDF = static_cast<std::stringstream&>(std::stringstream("").flush() << PlotScheme << ModelType << ID << "Merged" << PlotExtension.c_str()).str();
-      std::string Command = std::string("pdftk " + GlobalPDF + " " + IndividualPDF + " cat output " + NewPDF);
-      gSystem->Exec(Command.c_str());
-      gSystem->Exec(std::string("rm " + IndividualPDF).c_str());
-    }
   }
   else
   {
@@ -495,34 +1080,246 @@ void NESTModel::BasicModel::DrawGraphs()
       
 }
 
+void NESTModel::BasicModel::SetPlotBins(unsigned int First, unsigned int Last)
+{
+  //Makes this model a plotting worker of PlotFieldBins(), which only saves the images of its own field bins.
+  PlotWorker = true;
+  PlotBinFirst = First;
+  PlotBinLast = Last;
+}
+
+void NESTModel::BasicModel::PlotFieldBins(unsigned int NBins, const std::function<void(unsigned int Bin)>& Plot)
+{
+  //ROOT graphics are not thread safe, and this process already runs threads, so it can't fork either. The bins
+  //are split into contiguous ranges instead, and every range but the first is drawn by a new MinuitFitPlot
+  //process (next to this executable) in batch mode, which builds the model from its fit result file. The first
+  //range, and the ranges of the workers that could not start or failed, are drawn here.
+  unsigned int NWorkers(std::stoi(Settings->Query("PlotWorkers")));
+  if(NWorkers == 0) NWorkers = std::thread::hardware_concurrency(); //Zero means one process per core.
+  NWorkers = std::max(1u, std::min(NWorkers, NBins));
+  char Executable[4096];
+  ssize_t Length(readlink("/proc/self/exe", Executable, sizeof(Executable)-1));
+  std::string Program(Length > 0 ? std::string(Executable, Length) : "");
+  Program = Program.substr(0, Program.rfind('/') + 1) + "MinuitFitPlot";
+  if(FitResultFile.empty() || access(Program.c_str(), X_OK) != 0) NWorkers = 1; //Nothing to build the workers from.
+  std::vector<unsigned int> Bounds(NWorkers + 1);
+  for(unsigned int w(0); w <= NWorkers; ++w) Bounds[w] = w*NBins/NWorkers;
+  std::vector<pid_t> Workers(NWorkers, -1);
+  for(unsigned int w(1); w < NWorkers; ++w)
+  {
+    std::string Range(std::to_string(Bounds[w]) + "-" + std::to_string(Bounds[w+1]-1));
+    std::vector<char*> Arguments = {const_cast<char*>(Program.c_str()), const_cast<char*>("-b"), const_cast<char*>(Range.c_str())};
+    if(FitResultDataChanged) Arguments.push_back(const_cast<char*>("-f"));
+    Arguments.push_back(const_cast<char*>(FitResultFile.c_str()));
+    Arguments.push_back(nullptr);
+    if(posix_spawn(&Workers[w], Program.c_str(), nullptr, nullptr, Arguments.data(), environ) != 0) Workers[w] = -1;
+  }
+  for(unsigned int Bin(Bounds[0]); Bin < Bounds[1]; ++Bin) Plot(Bin);
+  for(unsigned int w(1); w < NWorkers; ++w)
+  {
+    int Status(0);
+    if(Workers[w] > 0 && waitpid(Workers[w], &Status, 0) == Workers[w] && WIFEXITED(Status) && WEXITSTATUS(Status) == 0) continue;
+    std::cerr << "NESTModel::BasicModel::PlotFieldBins(): The plotting worker of the field bins " << Bounds[w] << " to " << Bounds[w+1]-1 << " failed, so they are drawn here." << std::endl;
+    for(unsigned int Bin(Bounds[w]); Bin < Bounds[w+1]; ++Bin) Plot(Bin);
+  }
+}
+
+bool NESTModel::BasicModel::SaveContours()
+{
+  //Confidence contours of every pair of the parameters listed in "ContourParameters", at each chi-square
+  //increase of "ContourLevels". Like MultiStart(), each thread gets its own BasicModel, minimized again from
+  //the best fit, whose minimizer then runs MINOS contours for every NThreads-th pair. The graphs are written
+  //afterwards on this thread, since ROOT I/O is not thread safe. Does nothing unless "Contours" is true.
+  if(Settings->Query("Contours") != "true") return false;
+  if(!Converged)
+  {
+    std::cerr << "NESTModel::BasicModel::SaveContours(): The model has not been successfully minimized." << std::endl;
+    return false;
+  }
+  std::vector<unsigned int> Selected;
+  std::string Item;
+  std::stringstream ParameterList(Settings->Query("ContourParameters"));
+  while(std::getline(ParameterList, Item, ','))
+  {
+    if(Item == "all") for(unsigned int i(0); i < NPar; ++i) Selected.push_back(i);
+    else if(!Item.empty() && std::stoul(Item) < NPar) Selected.push_back(std::stoul(Item));
+  }
+  std::vector<double> Levels;
+  std::stringstream LevelList(Settings->Query("ContourLevels"));
+  while(std::getline(LevelList, Item, ',')) if(!Item.empty()) Levels.push_back(std::stod(Item));
+  std::vector< std::pair<unsigned int, unsigned int> > Pairs;
+  for(unsigned int a(0); a < Selected.size(); ++a) for(unsigned int b(a+1); b < Selected.size(); ++b) Pairs.push_back(std::make_pair(Selected.at(a), Selected.at(b)));
+  if(Pairs.empty() || Levels.empty()) return false;
+
+  unsigned int NPoints(std::stoi(Settings->Query("ContourPoints")));
+  std::vector< std::vector< std::vector<double> > > ContourX(Pairs.size(), std::vector< std::vector<double> >(Levels.size()));
+  std::vector< std::vector< std::vector<double> > > ContourY(ContourX);
+  {
+    ThreadPool ContourPool(std::stoi(Settings->Query("ContourThreads")));
+    unsigned int NTasks(std::min<unsigned int>(Pairs.size(), ContourPool.GetNThreads()));
+    std::vector< std::future<void> > Done;
+    for(unsigned int Task(0); Task < NTasks; ++Task)
+    {
+      std::shared_ptr<BasicModel> Run(new BasicModel(ModelType, ID, Settings, Data));
+      std::vector<double> Best(Parameters);
+      Done.push_back(ContourPool.Submit([Run, Best, Task, NTasks, NPoints, &Pairs, &Levels, &ContourX, &ContourY]()
+					{
+					  if(!Run->RunMinimizer(Best, std::stoi(Run->Settings->Query("MaxCalls")), false)) return;
+					  std::vector<double> X(NPoints), Y(NPoints);
+					  for(unsigned int Pair(Task); Pair < Pairs.size(); Pair += NTasks)
+					  {
+					    for(unsigned int Level(0); Level < Levels.size(); ++Level)
+					    {
+					      unsigned int Found(NPoints);
+					      Run->Minimizer->SetErrorDef(Levels.at(Level));
+					      if(Run->Minimizer->Contour(Pairs.at(Pair).first, Pairs.at(Pair).second, Found, X.data(), Y.data()))
+					      {
+						ContourX.at(Pair).at(Level).assign(X.begin(), X.begin() + Found);
+						ContourY.at(Pair).at(Level).assign(Y.begin(), Y.begin() + Found);
+					      }
+					    }
+					  }
+					}));
+    }
+    for(unsigned int Task(0); Task < Done.size(); ++Task) Done.at(Task).get();
+  }
+
+  TFile OutputFile(Settings->Query("ROOTName").c_str(), "UPDATE"); //Added next to the graphs of DrawGraphs().
+  if(!OutputFile.IsOpen())
+  {
+    std::cerr << "NESTModel::BasicModel::SaveContours(): Could not open " << Settings->Query("ROOTName") << "." << std::endl;
+    return false;
+  }
+  bool Complete(true);
+  for(unsigned int Pair(0); Pair < Pairs.size(); ++Pair)
+  {
+    for(unsigned int Level(0); Level < Levels.size(); ++Level)
+    {
+      std::string Name(static_cast<std::stringstream&>(std::stringstream("").flush() << "Contour_" << ModelType << ID << "_a" << Pairs.at(Pair).first << "_a" << Pairs.at(Pair).second << "_Level" << Level).str());
+      if(ContourX.at(Pair).at(Level).empty())
+      {
+	std::cerr << "NESTModel::BasicModel::SaveContours(): " << Name << " could not be found." << std::endl;
+	Complete = false;
+	continue;
+      }
+      TGraph Contour(ContourX.at(Pair).at(Level).size(), ContourX.at(Pair).at(Level).data(), ContourY.at(Pair).at(Level).data());
+      Contour.SetName(Name.c_str());
+      Contour.SetTitle(static_cast<std::stringstream&>(std::stringstream("").flush() << "#Delta#chi^{2} = " << Levels.at(Level) << ";a_{" << Pairs.at(Pair).first << "};a_{" << Pairs.at(Pair).second << "}").str().c_str());
+      Contour.Write();
+    }
+  }
+  OutputFile.Close();
+  return Complete;
+}
+
 void NESTModel::BasicModel::SetDefaultField(double Field) { DefaultField = Field; }
 
 std::vector<double>& NESTModel::BasicModel::GetParameters() { return Parameters; }
 
 std::vector<double>& NESTModel::BasicModel::GetParameterErrors() { return ParameterErrors; }
 
-TMatrixT<double>& NESTModel::BasicModel::GetCovariance() { return Covariance; }
+const std::vector<double>& NESTModel::BasicModel::GetCovariance() { return Covariance; }
+
+const std::vector<CovarianceBlock>& NESTModel::BasicModel::GetCovarianceBlocks() { return Data->GetCovarianceBlocks(); }
+
+const CovarianceObject& NESTModel::BasicModel::GetCovarianceFactor() { return Data->GetCovarianceFactor(); }
+
+std::shared_ptr<const DataObject> NESTModel::BasicModel::GetData() { return Data; }
 
-TMatrixT<double>& NESTModel::BasicModel::GetInvCovariance() { return InvCovariance; }
+std::shared_ptr<SettingsObject> NESTModel::BasicModel::GetSettings() { return Settings; }
 
 int NESTModel::BasicModel::GetNPar() { return NPar; }
 
 int NESTModel::BasicModel::GetNData() { return NData; }
 
-std::vector<double>& NESTModel::BasicModel::GetDataX() { return DataX; }
+std::string NESTModel::BasicModel::GetModelType() { return ModelType; }
+
+unsigned int NESTModel::BasicModel::GetID() { return ID; }
+
+bool NESTModel::BasicModel::IsDefined() { return Success; }
+
+bool NESTModel::BasicModel::IsConverged() { return Converged; }
+
+double NESTModel::BasicModel::GetChisquare() { return Chisquare; }
+
+double NESTModel::BasicModel::GetEDM() { return EDM; }
+
+double NESTModel::BasicModel::GetFitTime() { return FitTime; }
+
+int NESTModel::BasicModel::GetStatus() { return Status; }
 
-std::vector<double>& NESTModel::BasicModel::GetDataXErrLow() { return DataXErrLow; }
+unsigned long NESTModel::BasicModel::GetNCalls() { return FCN ? FCN->GetNCalls() + GradFCN->GetNCalls() + StartCalls : 0; }
 
-std::vector<double>& NESTModel::BasicModel::GetDataXErrHigh() { return DataXErrHigh; }
+unsigned int NESTModel::BasicModel::GetNStarts() { return NStarts; }
 
-std::vector<double>& NESTModel::BasicModel::GetDataY() { return DataY; }
+unsigned int NESTModel::BasicModel::GetBestStart() { return BestStart; }
 
-std::vector<double>& NESTModel::BasicModel::GetDataYErrLow() { return DataYErrLow; }
+const std::vector<double>& NESTModel::BasicModel::GetDataX() { return Data->GetDataX(); }
 
-std::vector<double>& NESTModel::BasicModel::GetDataYErrHigh() { return DataYErrHigh; }
+const std::vector<double>& NESTModel::BasicModel::GetDataXErrLow() { return Data->GetDataXErrLow(); }
 
-std::vector<double>& NESTModel::BasicModel::GetDataZ() { return DataZ; }
+const std::vector<double>& NESTModel::BasicModel::GetDataXErrHigh() { return Data->GetDataXErrHigh(); }
 
-std::vector<double>& NESTModel::BasicModel::GetDataZErrLow() { return DataZErrLow; }
+const std::vector<double>& NESTModel::BasicModel::GetDataY() { return Data->GetDataY(); }
 
-std::vector<double>& NESTModel::BasicModel::GetDataZErrHigh() { return DataZErrHigh; }
+const std::vector<double>& NESTModel::BasicModel::GetDataYErrLow() { return Data->GetDataYErrLow(); }
+
+const std::vector<double>& NESTModel::BasicModel::GetDataYErrHigh() { return Data->GetDataYErrHigh(); }
+
+const std::vector<double>& NESTModel::BasicModel::GetDataZ() { return Data->GetDataZ(); }
+
+const std::vector<double>& NESTModel::BasicModel::GetDataZErrLow() { return Data->GetDataZErrLow(); }
+
+const std::vector<double>& NESTModel::BasicModel::GetDataZErrHigh() { return Data->GetDataZErrHigh(); }
+
+NESTModel::ModelFCN::ModelFCN(BasicModel& model) : Model(&model), NCalls(0) {}
+
+ROOT::Math::IMultiGenFunction* NESTModel::ModelFCN::Clone() const { return new ModelFCN(*Model); }
+
+unsigned int NESTModel::ModelFCN::NDim() const { return Model->GetNPar(); }
+
+unsigned long NESTModel::ModelFCN::GetNCalls() const { return NCalls; }
+
+double NESTModel::ModelFCN::DoEval(const double* par) const
+{
+  ++NCalls;
+  return Model->Objective(par);
+}
+
+NESTModel::ModelGradFCN::ModelGradFCN(BasicModel& model) : Model(&model), NCalls(0) {}
+
+ROOT::Math::IMultiGradFunction* NESTModel::ModelGradFCN::Clone() const { return new ModelGradFCN(*Model); }
+
+unsigned int NESTModel::ModelGradFCN::NDim() const { return Model->GetNPar(); }
+
+unsigned long NESTModel::ModelGradFCN::GetNCalls() const { return NCalls; }
+
+double NESTModel::ModelGradFCN::DoEval(const double* par) const
+{
+  ++NCalls;
+  return Model->Chi2Covariance(par);
+}
+
+void NESTModel::ModelGradFCN::Gradient(const double* par, double* grad) const
+{
+  ++NCalls;
+  Model->Chi2Covariance(par, grad);
+}
+
+void NESTModel::ModelGradFCN::FdF(const double* par, double& f, double* grad) const
+{
+  ++NCalls;
+  f = Model->Chi2Covariance(par, grad);
+}
+
+double NESTModel::ModelGradFCN::DoDerivative(const double* par, unsigned int icoord) const
+{
+  //Minuit asks for the whole gradient at once; this is only here for other users of the interface.
+  if(GradientPoint.size() != NDim() || !std::equal(GradientPoint.begin(), GradientPoint.end(), par))
+  {
+    GradientPoint.assign(par, par+NDim());
+    GradientBuffer.resize(NDim());
+    Gradient(par, GradientBuffer.data());
+  }
+  return GradientBuffer.at(icoord);
+}
@@ -48,6 +48,11 @@ std::string SettingsObject::Query(std::string Key)
   return QueryResult; //Return the value associated with Key.
 }
 
+void SettingsObject::Set(std::string Key, std::string Value)
+{
+  SettingsMap[Key] = Value;
+}
+
 std::ostream& operator<<(std::ostream& os, const SettingsObject& Obj)
 {
   std::map<std::string, std::string>::const_iterator MapIt = Obj.SettingsMap.begin(); //Map iterator.
@@ -0,0 +1,52 @@
+//C++ includes.
+#include <thread> //For using std::thread.
+#include <mutex> //For using std::mutex.
+#include <functional> //For using std::function.
+
+//Custom includes.
+#include "ThreadPool.h" //Header file for this implementation.
+
+ThreadPool::ThreadPool(unsigned int NThreads)
+{
+  Stopping = false;
+  if(NThreads == 0) NThreads = std::thread::hardware_concurrency(); //Zero means one worker per core.
+  if(NThreads == 0) NThreads = 1; //hardware_concurrency() is allowed to return zero if it can't tell.
+  for(unsigned int i(0); i < NThreads; ++i) Workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> Lock(JobsMutex);
+    Stopping = true; //Workers finish the queued jobs before exiting.
+  }
+  JobsCondition.notify_all();
+  for(unsigned int i(0); i < Workers.size(); ++i) Workers.at(i).join();
+}
+
+unsigned int ThreadPool::GetNThreads() { return Workers.size(); }
+
+void ThreadPool::Enqueue(std::function<void()> Job)
+{
+  {
+    std::lock_guard<std::mutex> Lock(JobsMutex);
+    Jobs.push_back(Job);
+  }
+  JobsCondition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+  std::function<void()> Job;
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> Lock(JobsMutex);
+      JobsCondition.wait(Lock, [this]() { return Stopping || !Jobs.empty(); });
+      if(Jobs.empty()) return; //Only reached when stopping.
+      Job = Jobs.front();
+      Jobs.pop_front();
+    }
+    Job(); //Exceptions are captured by the packaged_task and rethrown from the future.
+  }
+}
@@ -0,0 +1,200 @@
+//C++ includes.
+#include <cmath> //Basic math functions, used for arguments outside of the range of the approximations.
+#include <cstring> //For std::memcpy.
+#include <cstdint> //Fixed width integers for manipulating the bits of a double.
+
+//Custom includes.
+#include "VectorKernels.h" //Header file for this implementation.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MINUITFIT_HAVE_AVX2 1
+#endif
+
+namespace
+{
+  //Constants for the range reduction of exp and log. Ln2Hi has trailing zero bits, so n*Ln2Hi is exact.
+  const double Log2e(1.4426950408889634074);
+  const double Ln2Hi(6.93147180369123816490e-01);
+  const double Ln2Lo(1.90821492927058770002e-10);
+  const int64_t Sqrt2Bits(0x3ff6a09e667f3bcdLL); //Bits of sqrt(2).
+  const double RoundMagic(6755399441055744.0); //1.5*2^52; adding it rounds to an integer held in the low mantissa bits.
+  const double ExponentMagic(4503599627370496.0); //2^52.
+  const uint64_t ExpLimitBits(0x4086200000000000ULL); //Bits of 708, the limit where 2^n stays a normal double.
+  const uint64_t MinNormalBits(0x0010000000000000ULL); //Bits of the smallest normal double.
+  const uint64_t InfinityBits(0x7ff0000000000000ULL); //Bits of infinity.
+
+  inline __attribute__((always_inline)) double ExpValue(double x)
+  {
+    //exp(x) = 2^n*exp(r) with |r| <= ln(2)/2, and exp(r) from its Taylor series to r^13 (error < 1e-17).
+    //Only valid for |x| <= 708; the result for other arguments is meaningless (but computed without undefined
+    //behaviour, in unsigned arithmetic) and has to be replaced by the caller.
+    double t(x*Log2e + RoundMagic);
+    uint64_t tBits, MagicBits;
+    std::memcpy(&tBits, &t, sizeof(double));
+    std::memcpy(&MagicBits, &RoundMagic, sizeof(double));
+    uint64_t n(tBits - MagicBits);
+    double nd(t - RoundMagic);
+    double r((x - nd*Ln2Hi) - nd*Ln2Lo);
+    double p(1.0/6227020800.0);
+    p = p*r + 1.0/479001600.0;
+    p = p*r + 1.0/39916800.0;
+    p = p*r + 1.0/3628800.0;
+    p = p*r + 1.0/362880.0;
+    p = p*r + 1.0/40320.0;
+    p = p*r + 1.0/5040.0;
+    p = p*r + 1.0/720.0;
+    p = p*r + 1.0/120.0;
+    p = p*r + 1.0/24.0;
+    p = p*r + 1.0/6.0;
+    p = p*r + 0.5;
+    p = p*r + 1.0;
+    p = p*r + 1.0;
+    uint64_t ScaleBits((n + 1023) << 52);
+    double Scale;
+    std::memcpy(&Scale, &ScaleBits, sizeof(double));
+    return p*Scale;
+  }
+
+  inline __attribute__((always_inline)) double LogValue(double x)
+  {
+    //log(x) = e*ln(2) + log(m) with sqrt(1/2) <= m < sqrt(2), and log(m) = 2*atanh(f) with f = (m-1)/(m+1).
+    //Only integer operations, so that the loops vectorize without branches.
+    int64_t Bits;
+    std::memcpy(&Bits, &x, sizeof(double));
+    int64_t MantissaBits((Bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL); //m in [1,2).
+    int64_t Large(static_cast<int64_t>(static_cast<uint64_t>(Sqrt2Bits - MantissaBits) >> 63)); //1 if m > sqrt(2), then m is halved.
+    MantissaBits -= Large << 52;
+    int64_t ExponentBits((((Bits >> 52) & 0x7ff) + Large) | 0x4330000000000000LL); //The biased exponent placed in the mantissa of 2^52.
+    double e, m;
+    std::memcpy(&e, &ExponentBits, sizeof(double));
+    std::memcpy(&m, &MantissaBits, sizeof(double));
+    e = e - ExponentMagic - 1023.0;
+    double f((m - 1.0)/(m + 1.0));
+    double s(f*f);
+    double p(1.0/23.0);
+    p = p*s + 1.0/21.0;
+    p = p*s + 1.0/19.0;
+    p = p*s + 1.0/17.0;
+    p = p*s + 1.0/15.0;
+    p = p*s + 1.0/13.0;
+    p = p*s + 1.0/11.0;
+    p = p*s + 1.0/9.0;
+    p = p*s + 1.0/7.0;
+    p = p*s + 1.0/5.0;
+    p = p*s + 1.0/3.0;
+    double LogM(2.0*f + 2.0*f*s*p);
+    return e*Ln2Hi + (LogM + e*Ln2Lo);
+  }
+
+  //Flags (1 if outside, 0 if inside) of the ranges covered by the approximations. They only use unsigned integer
+  //operations, so that they can be accumulated inside the vectorized loops. NaN is always flagged.
+  inline __attribute__((always_inline)) uint64_t BitsOf(double x)
+  {
+    uint64_t Bits;
+    std::memcpy(&Bits, &x, sizeof(double));
+    return Bits;
+  }
+  inline __attribute__((always_inline)) uint64_t ExpOutOfRange(double x) { return (ExpLimitBits - (BitsOf(x) & 0x7fffffffffffffffULL)) >> 63; } //|x| > 708.
+  inline __attribute__((always_inline)) uint64_t LogOutOfRange(double x)
+  {
+    uint64_t Bits(BitsOf(x));
+    return (Bits >> 63) | ((Bits - MinNormalBits) >> 63) | ((InfinityBits - 1 - Bits) >> 63); //Negative, zero or subnormal, infinite or NaN.
+  }
+}
+
+//Defines every kernel with the given name suffix and function attribute. The bodies are simple loops
+//so that the compiler vectorizes them for the instruction set selected by the attribute. Arguments the
+//approximations don't cover are fixed up afterwards in a second, rarely taken, loop.
+#define MINUITFIT_DEFINE_KERNELS(SUFFIX, ATTRIBUTE)			\
+  namespace								\
+  {									\
+    ATTRIBUTE void AddVV##SUFFIX(const double* a, const double* b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] + b[i]; } \
+    ATTRIBUTE void SubVV##SUFFIX(const double* a, const double* b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] - b[i]; } \
+    ATTRIBUTE void MulVV##SUFFIX(const double* a, const double* b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] * b[i]; } \
+    ATTRIBUTE void DivVV##SUFFIX(const double* a, const double* b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] / b[i]; } \
+    ATTRIBUTE void AddVU##SUFFIX(const double* a, double b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] + b; } \
+    ATTRIBUTE void SubVU##SUFFIX(const double* a, double b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] - b; } \
+    ATTRIBUTE void MulVU##SUFFIX(const double* a, double b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] * b; } \
+    ATTRIBUTE void DivVU##SUFFIX(const double* a, double b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] / b; } \
+    ATTRIBUTE void SubUV##SUFFIX(double a, const double* b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a - b[i]; } \
+    ATTRIBUTE void DivUV##SUFFIX(double a, const double* b, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a / b[i]; } \
+    ATTRIBUTE void Neg##SUFFIX(const double* a, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = -a[i]; } \
+    ATTRIBUTE void Square##SUFFIX(const double* a, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = a[i] * a[i]; } \
+    ATTRIBUTE void Sqrt##SUFFIX(const double* a, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = std::sqrt(a[i]); } \
+    ATTRIBUTE void Abs##SUFFIX(const double* a, double* out, unsigned int n) { for(unsigned int i(0); i < n; ++i) out[i] = std::fabs(a[i]); } \
+    ATTRIBUTE void Exp##SUFFIX(const double* a, double* out, unsigned int n) \
+    {									\
+      uint64_t Outside(0);						\
+      for(unsigned int i(0); i < n; ++i)				\
+      {									\
+	out[i] = ExpValue(a[i]);					\
+	Outside |= ExpOutOfRange(a[i]);					\
+      }									\
+      if(Outside) for(unsigned int i(0); i < n; ++i) if(ExpOutOfRange(a[i])) out[i] = std::exp(a[i]); \
+    }									\
+    ATTRIBUTE void Log##SUFFIX(const double* a, double* out, unsigned int n) \
+    {									\
+      uint64_t Outside(0);						\
+      for(unsigned int i(0); i < n; ++i)				\
+      {									\
+	out[i] = LogValue(a[i]);					\
+	Outside |= LogOutOfRange(a[i]);					\
+      }									\
+      if(Outside) for(unsigned int i(0); i < n; ++i) if(LogOutOfRange(a[i])) out[i] = std::log(a[i]); \
+    }									\
+    ATTRIBUTE void PowVV##SUFFIX(const double* a, const double* b, double* out, unsigned int n) \
+    {									\
+      uint64_t Outside(0);						\
+      for(unsigned int i(0); i < n; ++i)				\
+      {									\
+	double t(b[i]*LogValue(a[i]));					\
+	out[i] = ExpValue(t);						\
+	Outside |= LogOutOfRange(a[i]) | ExpOutOfRange(t);		\
+      }									\
+      if(Outside) for(unsigned int i(0); i < n; ++i) if(LogOutOfRange(a[i]) | ExpOutOfRange(b[i]*LogValue(a[i]))) out[i] = std::pow(a[i], b[i]); \
+    }									\
+    ATTRIBUTE void PowVU##SUFFIX(const double* a, double b, double* out, unsigned int n) \
+    {									\
+      uint64_t Outside(0);						\
+      for(unsigned int i(0); i < n; ++i)				\
+      {									\
+	double t(b*LogValue(a[i]));					\
+	out[i] = ExpValue(t);						\
+	Outside |= LogOutOfRange(a[i]) | ExpOutOfRange(t);		\
+      }									\
+      if(Outside) for(unsigned int i(0); i < n; ++i) if(LogOutOfRange(a[i]) | ExpOutOfRange(b*LogValue(a[i]))) out[i] = std::pow(a[i], b); \
+    }									\
+    ATTRIBUTE void PowUV##SUFFIX(double a, const double* b, double* out, unsigned int n) \
+    {									\
+      double LogA(LogValue(a));						\
+      uint64_t Outside(LogOutOfRange(a));				\
+      for(unsigned int i(0); i < n; ++i)				\
+      {									\
+	double t(b[i]*LogA);						\
+	out[i] = ExpValue(t);						\
+	Outside |= ExpOutOfRange(t);					\
+      }									\
+      if(Outside) for(unsigned int i(0); i < n; ++i) if(LogOutOfRange(a) | ExpOutOfRange(b[i]*LogA)) out[i] = std::pow(a, b[i]); \
+    }									\
+  }									\
+  static const VectorKernels Kernels##SUFFIX = { #SUFFIX,		\
+    AddVV##SUFFIX, SubVV##SUFFIX, MulVV##SUFFIX, DivVV##SUFFIX, PowVV##SUFFIX, \
+    AddVU##SUFFIX, SubVU##SUFFIX, MulVU##SUFFIX, DivVU##SUFFIX, PowVU##SUFFIX, \
+    SubUV##SUFFIX, DivUV##SUFFIX, PowUV##SUFFIX,			\
+    Neg##SUFFIX, Square##SUFFIX, Sqrt##SUFFIX, Abs##SUFFIX, Exp##SUFFIX, Log##SUFFIX };
+
+MINUITFIT_DEFINE_KERNELS(Generic, )
+#ifdef MINUITFIT_HAVE_AVX2
+MINUITFIT_DEFINE_KERNELS(AVX2, __attribute__((target("avx2"))))
+#endif
+
+const VectorKernels& VectorKernels::Get()
+{
+#ifdef MINUITFIT_HAVE_AVX2
+  static const bool HasAVX2(__builtin_cpu_supports("avx2")); //Checked once, on first use.
+  if(HasAVX2) return KernelsAVX2;
+#endif
+  return KernelsGeneric;
+}
+
+const VectorKernels& VectorKernels::GetGeneric() { return KernelsGeneric; }
@@ -0,0 +1,62 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Writes the file being read.
+#include <random> //Values of the file.
+#include <cstdio> //For std::snprintf and std::remove.
+#include <cstdlib> //For std::strtod, the reference.
+#include <cmath> //For std::pow.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "CSVReaderObject.h" //The reader being checked.
+#include "Check.h" //Checks of the tests.
+
+//Every value parsed by std::from_chars must be the double strtod gives for the same text, in every format the
+//data sets and logs use (fixed, scientific, 17 significant digits, explicit signs, spaces around the fields).
+//The file spans several chunks, so that it is parsed by the thread pool with lines split across chunks.
+int main()
+{
+  const std::string Name("/tmp/CSVReaderTest" + std::to_string(getpid()) + ".csv");
+  const char* Formats[] = {"%.17g", "%.6g", "%e", "%+.3f", " %.12E ", "%g"};
+  const unsigned int NColumns(6), NFormats(sizeof(Formats)/sizeof(Formats[0]));
+  std::mt19937_64 Engine(31415);
+  std::uniform_real_distribution<double> Mantissa(-1, 1), Exponent(-30, 30);
+  std::vector<double> Expected;
+  std::ofstream Output(Name);
+  Output << "#Comment, 1, 2\n";
+  char Text[64];
+  unsigned long Size(0);
+  for(unsigned long Row(0); Size < 5*CSVReaderObject::ChunkSize; ++Row)
+  {
+    std::string Line;
+    for(unsigned int c(0); c < NColumns; ++c)
+    {
+      double Value(Mantissa(Engine)*std::pow(10, Exponent(Engine)));
+      std::snprintf(Text, sizeof(Text), Formats[(Row + c) % NFormats], Value);
+      Expected.push_back(std::strtod(Text, nullptr));
+      Line += std::string(c ? "," : "") + Text;
+    }
+    Line += Row % 7 ? "\n" : "\r\n";
+    Output << Line;
+    Size += Line.size();
+  }
+  Output.close();
+
+  const unsigned int Threads[] = {1, 4};
+  for(unsigned int t(0); t < 2; ++t)
+  {
+    CSVReaderObject Reader(Name, Threads[t]);
+    std::vector<double> Values;
+    CHECK(Reader.IsOpen());
+    CHECK(Reader.Read(Values) == NColumns);
+    CHECK(Reader.GetNErrors() == 0);
+    CHECK(Values == Expected);
+    std::cout << Threads[t] << " threads: read " << Values.size() << " values, " << Reader.GetNErrors() << " errors." << std::endl;
+  }
+  std::remove(Name.c_str());
+  return CheckFailures();
+}
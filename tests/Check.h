@@ -0,0 +1,15 @@
+#ifndef CHECK_H
+#define CHECK_H
+//C++ includes.
+#include <iostream> //Reports the failed checks.
+
+//Minimal checks for the test executables, which are run by ctest. A failed check is reported with its file and
+//line, and main() returns CheckFailures(), so the test fails if any check did.
+inline int& CheckFailures()
+{
+  static int Failures(0);
+  return Failures;
+}
+
+#define CHECK(Condition) do { if(!(Condition)) { std::cerr << __FILE__ << ":" << __LINE__ << ": Check failed: " << #Condition << std::endl; ++CheckFailures(); } } while(0)
+#endif
@@ -0,0 +1,63 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "Models.h" //The model objects being evaluated.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "FunctionObject.h" //Initial parameters of the models.
+#include "AllocationCounter.h" //Counts the allocations of the evaluations.
+#include "Check.h" //Checks of the tests.
+
+//Once a model is set up, evaluating its chi-square must not allocate: every buffer is in the workspace of the
+//model, which MIGRAD and HESSE reuse for tens of thousands of calls. Checked on the real data sets, with and
+//without a recipe converting one of them. FitThreads is 1, since handing the chunks to the thread pool does allocate.
+int main()
+{
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  Settings->Set("FitThreads", "1");
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("WarmStart", "");
+  std::map<std::string, RecipeResult> Recipes; //Instead of the fit logs, which may not exist.
+  Recipes["NRTY0"].Parameters = {10, 0.01};
+  Recipes["NRTY0"].Covariance = {1, 0, 0, 1e-6};
+  Recipes["ERTY0"].Parameters = {51.3};
+  Recipes["ERTY0"].Covariance = {0.01};
+  const std::vector< std::pair<std::string, unsigned int> > Models = {{"NRQY", 0}, {"ERQY", 1}};
+  const unsigned int NCalls(20);
+
+  for(unsigned int m(0); m < Models.size(); ++m)
+  {
+    std::string Name(Models.at(m).first + std::to_string(Models.at(m).second));
+    std::shared_ptr<const DataObject> Data(NESTModel::BasicModel::LoadData(Settings, Models.at(m).first, Models.at(m).second, Recipes));
+    NESTModel::BasicModel Model(Models.at(m).first, Models.at(m).second, Settings, Data);
+    bool Defined(false);
+    FunctionObject Definition(Settings->Query("FunctionDefinitions"), Models.at(m).first, Models.at(m).second, Defined);
+    CHECK(Defined && Model.IsDefined());
+    if(!Defined || !Model.IsDefined()) continue;
+    std::vector<double> p(Definition.GetParameters()), Gradient(p.size());
+    Model.Chi2(p.data()); //Warm up: anything built lazily is built here.
+    Model.Chi2Covariance(p.data());
+    if(Model.HasGradient()) Model.Chi2Covariance(p.data(), Gradient.data());
+
+    unsigned long Before(GetNAllocations());
+    for(unsigned int c(0); c < NCalls; ++c) Model.Chi2(p.data());
+    unsigned long Chi2Allocations(GetNAllocations() - Before);
+    Before = GetNAllocations();
+    for(unsigned int c(0); c < NCalls; ++c) Model.Chi2Covariance(p.data());
+    unsigned long CovarianceAllocations(GetNAllocations() - Before);
+    Before = GetNAllocations();
+    for(unsigned int c(0); c < NCalls && Model.HasGradient(); ++c) Model.Chi2Covariance(p.data(), Gradient.data());
+    unsigned long GradientAllocations(GetNAllocations() - Before);
+    std::cout << Name << ": " << Chi2Allocations << ", " << CovarianceAllocations << " and " << GradientAllocations
+	      << " allocations in " << NCalls << " calls of Chi2, Chi2Covariance and its gradient." << std::endl;
+    CHECK(Chi2Allocations == 0);
+    CHECK(CovarianceAllocations == 0);
+    CHECK(GradientAllocations == 0);
+  }
+  return CheckFailures();
+}
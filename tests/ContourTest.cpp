@@ -0,0 +1,127 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <memory> //For using shared_ptr.
+#include <fstream> //Writes the definitions of the test model.
+#include <cmath> //For std::fabs.
+#include <cstdlib> //For std::system.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <stdlib.h> //For mkdtemp.
+#include <unistd.h> //For getcwd.
+
+//ROOT includes.
+#include "TFile.h" //Reads the contours back.
+#include "TGraph.h" //The contours.
+
+//Custom includes.
+#include "Models.h" //The model whose contours are computed.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "Check.h" //Checks of the tests.
+
+namespace
+{
+  //Reads the contour points of every pair from a .root file written by SaveContours(), empty where missing.
+  std::vector< std::vector<double> > ReadContours(const std::string& FileName, const std::vector<std::string>& Names)
+  {
+    std::vector< std::vector<double> > Points(Names.size());
+    TFile File(FileName.c_str());
+    for(unsigned int n(0); n < Names.size() && File.IsOpen(); ++n)
+    {
+      TGraph* Contour(dynamic_cast<TGraph*>(File.Get(Names[n].c_str())));
+      if(!Contour) continue;
+      for(int i(0); i < Contour->GetN(); ++i)
+      {
+	Points[n].push_back(Contour->GetX()[i]);
+	Points[n].push_back(Contour->GetY()[i]);
+      }
+      delete Contour;
+    }
+    return Points;
+  }
+}
+
+//Contours of every pair of parameters are computed concurrently, each thread with its own minimizer, so they must
+//not depend on the number of threads. A quadratic in the energy is fit to NRTotalYield, for which the chi-square
+//is quadratic in the parameters: the third parameter is then profiled exactly from three evaluations, and every
+//point of a contour must lie where the profiled chi-square is ContourLevels above the minimum. The definitions
+//and contours are written in a temporary directory. Run in the top level directory.
+int main()
+{
+  char Buffer[4096];
+  CHECK(getcwd(Buffer, sizeof(Buffer)) != nullptr);
+  std::string Source(Buffer);
+  char Directory[] = "/tmp/ContourTest.XXXXXX";
+  CHECK(mkdtemp(Directory) != nullptr);
+  std::string Definitions(std::string(Directory) + "/Definitions.txt");
+  std::ofstream Output(Definitions);
+  Output << "CTTYSets:\"" << Source << "/NRTotalYield\"" << std::endl;
+  Output << "CTTYRecipes:\".\"" << std::endl;
+  Output << "CTTYF0:\"[0]+[1]*(x/10)+[2]*(x/10)*(x/10)\"" << std::endl;
+  Output << "CTTYP0:\"10,1,0\"" << std::endl;
+  Output << "CTTYLL0:\"0,0,0\"" << std::endl;
+  Output << "CTTYLH0:\"0,0,0\"" << std::endl;
+  Output << "CTTYS0:\"0.1,0.1,0.01\"" << std::endl;
+  Output.close();
+
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  Settings->Set("FunctionDefinitions", Definitions);
+  Settings->Set("Chi2", "Covariance");
+  Settings->Set("FitThreads", "1");
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("WarmStart", "");
+  Settings->Set("MultiStarts", "1");
+  Settings->Set("FitCache", "");
+  Settings->Set("FitResults", "false");
+  Settings->Set("FitStore", "");
+  Settings->Set("Contours", "true");
+  Settings->Set("ContourParameters", "all");
+  Settings->Set("ContourLevels", "2.30");
+  Settings->Set("ContourPoints", "20");
+  NESTModel::BasicModel Model("CTTY", 0, Settings, nullptr);
+  CHECK(Model.IsDefined());
+  CHECK(Model.Minimize());
+  if(!Model.IsConverged()) return CheckFailures();
+
+  const unsigned int Pairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+  std::vector<std::string> Names;
+  for(unsigned int Pair(0); Pair < 3; ++Pair) Names.push_back("Contour_CTTY0_a" + std::to_string(Pairs[Pair][0]) + "_a" + std::to_string(Pairs[Pair][1]) + "_Level0");
+  std::vector< std::vector<double> > Points[2];
+  const char* Threads[2] = {"1", "3"};
+  for(unsigned int t(0); t < 2; ++t)
+  {
+    std::string ROOTName(std::string(Directory) + "/Contours" + Threads[t] + ".root");
+    Settings->Set("ROOTName", ROOTName);
+    Settings->Set("ContourThreads", Threads[t]);
+    CHECK(Model.SaveContours());
+    Points[t] = ReadContours(ROOTName, Names);
+  }
+  CHECK(Points[0] == Points[1]);
+
+  const std::vector<double> Best(Model.GetParameters());
+  const double Minimum(Model.GetChisquare()), Level(2.30);
+  for(unsigned int Pair(0); Pair < 3; ++Pair)
+  {
+    const std::vector<double>& Contour(Points[0][Pair]);
+    CHECK(Contour.size() >= 2*10); //Most of the 20 points are found.
+    unsigned int Profiled(3 - Pairs[Pair][0] - Pairs[Pair][1]);
+    double Step(Model.GetParameterErrors().at(Profiled));
+    for(unsigned int i(0); i + 1 < Contour.size(); i += 2)
+    {
+      std::vector<double> p(Best);
+      p[Pairs[Pair][0]] = Contour[i];
+      p[Pairs[Pair][1]] = Contour[i+1];
+      double Center(Model.Objective(p.data()));
+      p[Profiled] = Best[Profiled] + Step;
+      double Above(Model.Objective(p.data()));
+      p[Profiled] = Best[Profiled] - Step;
+      double Below(Model.Objective(p.data()));
+      double Profile(Center - (Above - Below)*(Above - Below)/(8*(Above - 2*Center + Below))); //Vertex of the parabola.
+      CHECK(std::fabs(Profile - Minimum - Level) < 0.05*Level);
+    }
+  }
+  std::system(("rm -rf '" + std::string(Directory) + "'").c_str());
+  return CheckFailures();
+}
@@ -0,0 +1,120 @@
+//C++ includes.
+#include <vector> //STL vector.
+#include <random> //Covariances and residuals.
+#include <cmath> //For std::sqrt and std::fabs.
+#include <algorithm> //For std::max.
+#include <memory> //For using shared_ptr.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "CovarianceObject.h" //The covariance being checked.
+#include "ThreadPool.h" //Solves the blocks concurrently.
+#include "Check.h" //Checks of the tests.
+
+namespace
+{
+  //r^T*V^-1*r and V^-1*r of a dense symmetric positive definite matrix, by Cholesky decomposition.
+  double DenseChi2(std::vector<double> V, const double* r, unsigned int n, std::vector<double>& Weights)
+  {
+    for(unsigned int j(0); j < n; ++j)
+    {
+      for(unsigned int k(0); k < j; ++k) V[j*n+j] -= V[j*n+k]*V[j*n+k];
+      V[j*n+j] = std::sqrt(V[j*n+j]);
+      for(unsigned int i(j+1); i < n; ++i)
+      {
+	for(unsigned int k(0); k < j; ++k) V[i*n+j] -= V[i*n+k]*V[j*n+k];
+	V[i*n+j] /= V[j*n+j];
+      }
+    }
+    Weights.assign(r, r+n);
+    for(unsigned int i(0); i < n; ++i) //L*z = r.
+    {
+      for(unsigned int k(0); k < i; ++k) Weights[i] -= V[i*n+k]*Weights[k];
+      Weights[i] /= V[i*n+i];
+    }
+    double Chi2(0);
+    for(unsigned int i(0); i < n; ++i) Chi2 += Weights[i]*Weights[i];
+    for(unsigned int i(n); i-- > 0;) //L^T*w = z.
+    {
+      for(unsigned int k(i+1); k < n; ++k) Weights[i] -= V[k*n+i]*Weights[k];
+      Weights[i] /= V[i*n+i];
+    }
+    return Chi2;
+  }
+}
+
+//The chi-square of the diagonal plus low rank blocks, solved by the Woodbury identity, is compared with the
+//dense matrices D + U*U^T solved directly, for blocks of several sizes and ranks, including rank 0 (diagonal) and
+//a factor whose columns are strongly correlated, like the ones recipes give. Solving the blocks on 1, 2 and 8
+//threads must give bit-identical results.
+int main()
+{
+  std::mt19937_64 Engine(1618);
+  std::uniform_real_distribution<double> Unit(0, 1);
+  const unsigned int Sizes[] = {1, 40, 300, 7, 120};
+  const unsigned int Ranks[] = {0, 1, 3, 2, 4};
+  std::vector<CovarianceBlock> Blocks;
+  std::vector<double> Residuals;
+  for(unsigned int b(0); b < 5; ++b)
+  {
+    CovarianceBlock Block;
+    Block.Rank = Ranks[b];
+    for(unsigned int i(0); i < Sizes[b]; ++i)
+    {
+      double Yield(1 + 10*Unit(Engine));
+      Block.Diagonal.push_back(std::pow(0.05*Yield, 2)*(0.5 + Unit(Engine)));
+      double Shared(Unit(Engine));
+      for(unsigned int k(0); k < Block.Rank; ++k) Block.Factor.push_back(Yield*(b == 4 ? 0.3*Shared + 1e-3*Unit(Engine) : 0.1*(Unit(Engine) - 0.5)));
+      Residuals.push_back(0.2*Yield*(Unit(Engine) - 0.5));
+    }
+    Blocks.push_back(Block);
+  }
+  bool Success(false);
+  CovarianceObject Covariance(Blocks, Success);
+  CHECK(Success);
+
+  //Dense reference, block by block.
+  double Reference(0);
+  std::vector<double> ReferenceWeights;
+  for(unsigned int b(0); b < Blocks.size(); ++b)
+  {
+    unsigned int n(Sizes[b]), k(Ranks[b]);
+    std::vector<double> V(n*n, 0), Weights;
+    for(unsigned int i(0); i < n; ++i)
+    {
+      V[i*n+i] = Blocks[b].Diagonal[i];
+      for(unsigned int j(0); j < n; ++j) for(unsigned int l(0); l < k; ++l) V[i*n+j] += Blocks[b].Factor[i*k+l]*Blocks[b].Factor[j*k+l];
+    }
+    Reference += DenseChi2(V, Residuals.data() + Covariance.GetBlockOffset(b), n, Weights);
+    ReferenceWeights.insert(ReferenceWeights.end(), Weights.begin(), Weights.end());
+  }
+
+  const unsigned int Threads[] = {1, 2, 8};
+  double Chi2[3];
+  std::vector<double> Weights[3];
+  std::vector<double> Workspace(Covariance.GetWorkspaceSize());
+  for(unsigned int t(0); t < 3; ++t)
+  {
+    std::shared_ptr<ThreadPool> Pool;
+    if(Threads[t] > 1) Pool.reset(new ThreadPool(Threads[t]));
+    Weights[t].resize(Covariance.GetN());
+    Chi2[t] = Covariance.Chi2(Residuals.data(), Workspace.data(), Weights[t].data(), Pool.get());
+    CHECK(Chi2[t] == Covariance.Chi2(Residuals.data(), Workspace.data(), Pool.get()));
+  }
+  double WeightError(0), WeightScale(0);
+  for(unsigned int i(0); i < ReferenceWeights.size(); ++i)
+  {
+    WeightError = std::max(WeightError, std::fabs(Weights[0][i] - ReferenceWeights[i]));
+    WeightScale = std::max(WeightScale, std::fabs(ReferenceWeights[i]));
+  }
+  std::cout << "Chi-square " << Chi2[0] << ", dense " << Reference << "; the weights differ by " << WeightError/WeightScale << " relative." << std::endl;
+  CHECK(std::fabs(Chi2[0] - Reference) < 1e-10*Reference);
+  CHECK(WeightError < 1e-10*WeightScale);
+  CHECK(std::fabs(Covariance.Chi2(Residuals.data()) - Chi2[0]) < 1e-12*Chi2[0]);
+  for(unsigned int t(1); t < 3; ++t)
+  {
+    CHECK(Chi2[t] == Chi2[0]);
+    CHECK(Weights[t] == Weights[0]);
+  }
+  return CheckFailures();
+}
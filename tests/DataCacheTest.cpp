@@ -0,0 +1,98 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Writes the data sets.
+#include <cstdio> //For std::remove.
+#include <iostream> //Basic input and output.
+#include <thread> //Saves the cache concurrently.
+#include <atomic> //Counts the failed saves.
+
+//POSIX includes.
+#include <sys/stat.h> //Modification time of the data set.
+#include <utime.h> //Restores it after an edit.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "DataCacheObject.h" //The cache being checked.
+#include "CSVReaderObject.h" //Parses the data sets.
+#include "Check.h" //Checks of the tests.
+
+namespace
+{
+  void Write(const std::string& FileName, const std::string& Text)
+  {
+    std::ofstream Output(FileName);
+    Output << Text;
+  }
+
+  std::vector< std::vector<double> > Split(const std::vector<double>& Values)
+  {
+    std::vector< std::vector<double> > Columns(DataCacheObject::NColumns);
+    for(unsigned int i(0); i < Values.size(); ++i) Columns.at(i % DataCacheObject::NColumns).push_back(Values[i]);
+    return Columns;
+  }
+}
+
+//A cached data set must be read back exactly, and must not be used once the CSV or the defaults applied to it
+//changed, even by an edit that keeps the size and modification time of the CSV. A CSV with rows that could not
+//be read reports them, so that it is not cached. Models loading the same set on several threads may all save its
+//cache at once, and every save must still leave a whole cache.
+int main()
+{
+  const std::string Name("/tmp/DataCacheTest" + std::to_string(getpid()) + ".csv");
+  const std::vector<double> Defaults = {0.1, 0.05, 0.05, 10};
+  Write(Name, "#Set\n1.5,0.1,0.1,100,0,0,3.25,0.2,0.2\n2.5,0.1,0.1,200,0,0,4.75,0.2,0.2\n");
+  std::vector<double> Values;
+  CSVReaderObject Reader(Name);
+  CHECK(Reader.Read(Values, DataCacheObject::NColumns) == DataCacheObject::NColumns && Reader.GetNErrors() == 0);
+  std::vector< std::vector<double> > Columns(Split(Values));
+  {
+    DataCacheObject Cache(Name, Defaults);
+    CHECK(!Cache.Load());
+    CHECK(Cache.Save(Columns));
+  }
+  {
+    DataCacheObject Cache(Name, Defaults);
+    CHECK(Cache.Load() && Cache.GetNRows() == 2);
+    for(unsigned int c(0); c < DataCacheObject::NColumns && Cache.GetNRows() == 2; ++c) CHECK(std::vector<double>(Cache.GetColumn(c), Cache.GetColumn(c) + 2) == Columns.at(c));
+  }
+  {
+    DataCacheObject Cache(Name, {0.1, 0.05, 0.05, 20});
+    CHECK(!Cache.Load());
+  }
+  std::atomic<unsigned int> NFailed(0);
+  std::vector<std::thread> Savers;
+  for(unsigned int t(0); t < 8; ++t) Savers.push_back(std::thread([&]()
+								   {
+								     for(unsigned int s(0); s < 50; ++s) if(!DataCacheObject(Name, Defaults).Save(Columns)) ++NFailed;
+								   }));
+  for(unsigned int t(0); t < Savers.size(); ++t) Savers[t].join();
+  CHECK(NFailed == 0);
+  {
+    DataCacheObject Cache(Name, Defaults);
+    CHECK(Cache.Load() && Cache.GetNRows() == 2);
+    for(unsigned int c(0); c < DataCacheObject::NColumns && Cache.GetNRows() == 2; ++c) CHECK(std::vector<double>(Cache.GetColumn(c), Cache.GetColumn(c) + 2) == Columns.at(c));
+  }
+
+  //Same size and modification time, different values.
+  struct stat Status;
+  CHECK(stat(Name.c_str(), &Status) == 0);
+  Write(Name, "#Set\n1.5,0.1,0.1,100,0,0,3.25,0.2,0.2\n2.5,0.1,0.1,200,0,0,4.76,0.2,0.2\n");
+  struct utimbuf Times;
+  Times.actime = Status.st_atime;
+  Times.modtime = Status.st_mtime;
+  CHECK(utime(Name.c_str(), &Times) == 0);
+  {
+    DataCacheObject Cache(Name, Defaults);
+    CHECK(!Cache.Load());
+  }
+
+  //A ragged row is left out and counted.
+  Write(Name, "1.5,0.1,0.1,100,0,0,3.25,0.2,0.2\n2.5,0.1,0.1,200,0,0,4.75,0.2\n");
+  CSVReaderObject Ragged(Name);
+  CHECK(Ragged.Read(Values, DataCacheObject::NColumns) == DataCacheObject::NColumns);
+  CHECK(Ragged.GetNErrors() == 1 && Values.size() == DataCacheObject::NColumns);
+  std::remove(Name.c_str());
+  std::remove((Name + ".cache").c_str());
+  return CheckFailures();
+}
@@ -0,0 +1,155 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Lists the models of the definitions file.
+#include <regex> //Matches the keys of the model functions.
+#include <random> //Points the formulas are compared at.
+#include <cmath> //Reference functions.
+#include <algorithm> //For std::max.
+#include <iostream> //Basic input and output.
+#include <cstdlib> //For std::system.
+#include <memory> //For using shared_ptr.
+
+//POSIX includes.
+#include <stdlib.h> //For mkdtemp.
+
+//Custom includes.
+#include "ExpressionObject.h" //The compiled formulas being checked.
+#include "CompiledFunctionObject.h" //Builds the formulas with the system compiler, as references.
+#include "DefinitionsObject.h" //Model functions and parameters.
+#include "VectorKernels.h" //The polynomial exp, log and pow.
+#include "Check.h" //Checks of the tests.
+
+namespace
+{
+  const double Tolerance(1e-10); //Relative; the two differ by the order of the operations and by the kernels.
+
+  std::vector<double> ReadNumbers(const std::string& Text)
+  {
+    std::vector<double> Numbers;
+    std::size_t Start(0);
+    while(Start <= Text.size())
+    {
+      std::size_t End(Text.find(',', Start));
+      if(End == std::string::npos) End = Text.size();
+      Numbers.push_back(std::stod(Text.substr(Start, End-Start)));
+      Start = End+1;
+    }
+    return Numbers;
+  }
+
+  //Largest relative difference of a kernel from <cmath> over the arguments, with both kernel sets.
+  double KernelError(VectorKernels::Unary VectorKernels::*Kernel, double (*Reference)(double), const std::vector<double>& a)
+  {
+    double Error(0);
+    std::vector<double> Out(a.size());
+    const VectorKernels* Sets[] = {&VectorKernels::Get(), &VectorKernels::GetGeneric()};
+    for(unsigned int s(0); s < 2; ++s)
+    {
+      (Sets[s]->*Kernel)(a.data(), Out.data(), a.size());
+      for(unsigned int i(0); i < a.size(); ++i) Error = std::max(Error, std::fabs(Out[i] - Reference(a[i]))/std::fabs(Reference(a[i])));
+    }
+    return Error;
+  }
+}
+
+//The formula compiler and its polynomial exp, log and pow replace TFormula and libm in the chi-square, so every
+//function of ModelDefinitions.txt is compared with the same formula built by the system compiler against libm
+//(which is also what TFormula evaluates), over the range of the data, with the initial parameters P.
+//Run in the top level directory. Formulas the compiler rejects are left to TFormula by BasicModel, and are listed.
+int main()
+{
+  std::mt19937_64 Engine(12345);
+  std::uniform_real_distribution<double> Unit(0, 1);
+  std::vector<double> Arguments(4096);
+
+  //The kernels, over the ranges the models use them in.
+  for(unsigned int i(0); i < Arguments.size(); ++i) Arguments[i] = -700 + 1400*Unit(Engine);
+  double ExpError(KernelError(&VectorKernels::Exp, static_cast<double (*)(double)>(std::exp), Arguments));
+  for(unsigned int i(0); i < Arguments.size(); ++i) Arguments[i] = std::exp(-700 + 1400*Unit(Engine));
+  double LogError(KernelError(&VectorKernels::Log, static_cast<double (*)(double)>(std::log), Arguments));
+  std::cout << "Exp and Log differ from <cmath> by " << ExpError << " and " << LogError << " relative." << std::endl;
+  CHECK(ExpError < 1e-15);
+  CHECK(LogError < 1e-15);
+  std::vector<double> Bases(Arguments.size()), Exponents(Arguments.size()), Powers(Arguments.size());
+  for(unsigned int i(0); i < Bases.size(); ++i)
+  {
+    Bases[i] = std::exp(-20 + 40*Unit(Engine));
+    Exponents[i] = -50 + 100*Unit(Engine);
+  }
+  const VectorKernels* Sets[] = {&VectorKernels::Get(), &VectorKernels::GetGeneric()};
+  for(unsigned int s(0); s < 2; ++s)
+  {
+    Sets[s]->PowVV(Bases.data(), Exponents.data(), Powers.data(), Bases.size());
+    double PowError(0); //Relative to the conditioning of pow, |b*log(a)|.
+    for(unsigned int i(0); i < Bases.size(); ++i)
+    {
+      double Reference(std::pow(Bases[i], Exponents[i]));
+      PowError = std::max(PowError, std::fabs(Powers[i] - Reference)/std::fabs(Reference)/std::max(1.0, std::fabs(Exponents[i]*std::log(Bases[i]))));
+    }
+    std::cout << "Pow of the " << Sets[s]->Name << " kernels differs from <cmath> by " << PowError << " relative, per unit of |b*log(a)|." << std::endl;
+    CHECK(PowError < 1e-15);
+  }
+
+  //A division of integer literals is 0 in C++ and TFormula, so it is rejected rather than evaluated in double.
+  bool Parsed(true);
+  ExpressionObject IntegerDivision("x*(1/2)", Parsed);
+  CHECK(!Parsed);
+  ExpressionObject DoubleDivision("x*(1./2)", Parsed);
+  CHECK(Parsed && DoubleDivision.Evaluate(3, 0, nullptr) == 1.5);
+
+  //Every model function.
+  char Directory[] = "/tmp/ExpressionAccuracyTest.XXXXXX";
+  CHECK(mkdtemp(Directory) != nullptr);
+  std::shared_ptr<const DefinitionsObject> Definitions(DefinitionsObject::Get("ModelDefinitions.txt"));
+  CHECK(Definitions->IsOpen());
+  std::ifstream Input("ModelDefinitions.txt");
+  std::string Line;
+  std::regex FunctionKey("^([A-Z]+)F([0-9]+)$");
+  unsigned int NModels(0);
+  const unsigned int NPoints(1000);
+  std::vector<double> X(NPoints), Y(NPoints), Values(NPoints), References(NPoints);
+  for(unsigned int i(0); i < NPoints; ++i)
+  {
+    X[i] = 1 + 99*Unit(Engine); //Energy in keV.
+    Y[i] = 10 + 990*Unit(Engine); //Field in V/cm.
+  }
+  while(std::getline(Input, Line))
+  {
+    std::smatch Match;
+    std::string Key(Line.substr(0, Line.find(':')));
+    if(Line.empty() || Line[0] == '#' || !std::regex_match(Key, Match, FunctionKey)) continue;
+    std::string Name(Match[1].str() + Match[2].str()), Formula, Initial;
+    unsigned int ID(std::stoul(Match[2].str()));
+    if(!Definitions->Find(Key, Formula) || !Definitions->Find(Match[1].str(), "P", ID, Initial)) continue;
+    bool Built(false);
+    ExpressionObject Expression(Formula, Parsed);
+    if(!Parsed)
+    {
+      std::cout << Name << " is left to TFormula." << std::endl;
+      continue;
+    }
+    CompiledFunctionObject Reference(Formula, Directory, "c++", Built);
+    CHECK(Built);
+    if(!Built) continue;
+    std::vector<double> p(ReadNumbers(Initial));
+    p.resize(std::max<std::size_t>(p.size(), Expression.GetNPar()), 0); //Models reading past P are rejected by FunctionObject.
+    std::vector<double> Workspace(Expression.GetWorkspaceSize());
+    Expression.Evaluate(X.data(), Y.data(), p.data(), Values.data(), NPoints, Workspace.data());
+    Reference.Evaluate(X.data(), Y.data(), p.data(), References.data(), NPoints);
+    double Error(0);
+    for(unsigned int i(0); i < NPoints; ++i)
+    {
+      if(std::isnan(References[i]) && std::isnan(Values[i])) continue;
+      double Scalar(Expression.Evaluate(X[i], Y[i], p.data()));
+      Error = std::max(Error, std::fabs(Values[i] - References[i])/std::max(std::fabs(References[i]), 1e-300));
+      Error = std::max(Error, std::fabs(Scalar - References[i])/std::max(std::fabs(References[i]), 1e-300));
+    }
+    std::cout << Name << " differs from the compiled reference by " << Error << " relative." << std::endl;
+    CHECK(Error < Tolerance);
+    ++NModels;
+  }
+  CHECK(NModels > 0);
+  std::system(("rm -rf '" + std::string(Directory) + "'").c_str());
+  return CheckFailures();
+}
@@ -0,0 +1,51 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <limits> //For std::numeric_limits.
+#include <cstdio> //For std::remove.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "FitResultObject.h" //The fit result file being checked.
+#include "Check.h" //Checks of the tests.
+
+//MinuitFitPlot draws the plots of a fit from its result file alone, so every number must be read back as the
+//same double, and formulas (which contain ':' and spaces) as the same text.
+int main()
+{
+  const std::string Name("/tmp/FitResultTest" + std::to_string(getpid()) + ".txt");
+  const std::string Function("[0]*TMath::Power(x,[1])/(1+[2]*TMath::Exp(-y/[3]))");
+  const std::vector<double> Parameters = {0.1, 1.0/3, -2.5e-300, std::numeric_limits<double>::denorm_min(), 6.02214076e23, -0.0};
+  std::vector<double> Covariance;
+  for(unsigned int i(0); i < Parameters.size()*Parameters.size(); ++i) Covariance.push_back(1.0/(i+7));
+  {
+    FitResultObject Result;
+    Result.Set("ModelType", "NRQY");
+    Result.Set("ModelID", 3);
+    Result.Set("Function", Function);
+    Result.Set("Chisquare", 123.456789012345678);
+    Result.Set("Parameters", Parameters);
+    Result.Set("Covariance", Covariance);
+    Result.Set("Sets", "NRChargeYield,NRLightYield");
+    Result.Set("Recipes", ".,NRTY0");
+    CHECK(Result.Save(Name));
+  }
+  FitResultObject Result;
+  CHECK(Result.Load(Name));
+  CHECK(Result.Get("ModelType") == "NRQY");
+  CHECK(Result.Get("ModelID") == "3");
+  CHECK(Result.Get("Function") == Function);
+  CHECK(Result.GetNumber("Chisquare") == 123.456789012345678);
+  CHECK(Result.GetNumbers("Parameters") == Parameters);
+  CHECK(Result.GetNumbers("Covariance") == Covariance);
+  CHECK(Result.Get("Sets") == "NRChargeYield,NRLightYield");
+  CHECK(Result.Get("Recipes") == ".,NRTY0");
+  CHECK(!Result.Has("DataKey") && Result.Get("DataKey").empty());
+  std::remove(Name.c_str());
+  FitResultObject Missing;
+  CHECK(!Missing.Load(Name));
+  return CheckFailures();
+}
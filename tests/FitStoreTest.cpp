@@ -0,0 +1,100 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <cstdio> //For std::remove.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <unistd.h> //For fork and getpid.
+#include <sys/wait.h> //Waits for the writers.
+
+//Custom includes.
+#include "FitStoreObject.h" //The fit store being checked.
+#include "Check.h" //Checks of the tests.
+
+namespace
+{
+  FitStoreObject::Record MakeRecord(unsigned int Writer, unsigned int Index)
+  {
+    //Every field derives from the writer and its index, so a record read back can be checked on its own.
+    FitStoreObject::Record Entry;
+    Entry.ModelType = "NRQY";
+    Entry.ModelID = Writer;
+    Entry.FormulaHash = 1000003ull*Writer + Index;
+    Entry.DataHash = 7;
+    Entry.Chisquare = Index + 0.25*Writer;
+    Entry.EDM = 1e-6;
+    Entry.Status = 0;
+    Entry.NFree = 1 + Index % 4;
+    Entry.NData = 100;
+    Entry.Converged = true;
+    Entry.FromCache = Index % 2;
+    Entry.NCalls = Index;
+    Entry.FitTime = 0.5;
+    unsigned int NPar(Entry.NFree);
+    for(unsigned int p(0); p < NPar; ++p)
+    {
+      Entry.Parameters.push_back(Writer + 0.001*Index + p);
+      Entry.Errors.push_back(0.1*p);
+    }
+    for(unsigned int p(0); p < NPar*NPar; ++p) Entry.Covariance.push_back(Index - 0.5*p);
+    return Entry;
+  }
+}
+
+//Fits running in several processes append to one store under a file lock. Every record they appended must be
+//read back whole, with the arrays it was appended with, and in the order each process appended them.
+int main()
+{
+  const std::string Name("/tmp/FitStoreTest" + std::to_string(getpid()));
+  const unsigned int NWriters(4), NRecords(250);
+  std::vector<pid_t> Writers;
+  for(unsigned int w(0); w < NWriters; ++w)
+  {
+    pid_t Writer(fork());
+    if(Writer == 0)
+    {
+      FitStoreObject Store(Name);
+      bool Appended(true);
+      for(unsigned int r(0); r < NRecords; ++r) Appended = Store.Append(MakeRecord(w, r)) && Appended;
+      _exit(Appended ? 0 : 1);
+    }
+    CHECK(Writer > 0);
+    Writers.push_back(Writer);
+  }
+  for(unsigned int w(0); w < Writers.size(); ++w)
+  {
+    int Status(0);
+    CHECK(waitpid(Writers.at(w), &Status, 0) == Writers.at(w) && WIFEXITED(Status) && WEXITSTATUS(Status) == 0);
+  }
+
+  FitStoreObject Store(Name);
+  CHECK(Store.Load());
+  CHECK(Store.GetNRecords() == NWriters*NRecords);
+  std::vector<unsigned int> Next(NWriters, 0);
+  for(std::size_t i(0); i < Store.GetNRecords(); ++i)
+  {
+    unsigned int w(Store.GetModelIDs()[i]);
+    CHECK(w < NWriters);
+    if(w >= NWriters) break;
+    FitStoreObject::Record Expected(MakeRecord(w, Next.at(w)++));
+    CHECK(Store.GetModelTypes()[i] == Expected.ModelType && Store.GetFormulaHashes()[i] == Expected.FormulaHash);
+    CHECK(Store.GetChisquares()[i] == Expected.Chisquare && Store.GetNFrees()[i] == Expected.NFree && Store.GetNPars()[i] == Expected.Parameters.size());
+    CHECK(Store.GetFlags()[i] == (1u | (Expected.FromCache ? 2u : 0u)));
+    std::vector<double> Parameters, Errors, Covariance;
+    CHECK(Store.GetArrays(i, Parameters, Errors, Covariance));
+    CHECK(Parameters == Expected.Parameters && Errors == Expected.Errors && Covariance == Expected.Covariance);
+  }
+  for(unsigned int w(0); w < NWriters; ++w) CHECK(Next.at(w) == NRecords);
+
+  //Ranking by a column keeps the order of the store for ties.
+  std::vector<std::size_t> Selected(Store.Select([&](std::size_t i) { return Store.GetModelIDs()[i] == 0; }));
+  CHECK(Selected.size() == NRecords);
+  std::vector<double> Column(Store.GetNRecords(), 0);
+  for(std::size_t i(0); i < Column.size(); ++i) Column[i] = -static_cast<double>(Store.GetNCalls()[i] % 10);
+  Store.Rank(Selected, Column);
+  for(std::size_t r(1); r < Selected.size(); ++r) CHECK(Column[Selected[r-1]] < Column[Selected[r]] || (Column[Selected[r-1]] == Column[Selected[r]] && Selected[r-1] < Selected[r]));
+  std::remove((Name + ".idx").c_str());
+  std::remove((Name + ".dat").c_str());
+  return CheckFailures();
+}
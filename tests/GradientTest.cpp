@@ -0,0 +1,70 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <cmath> //For std::fabs.
+#include <algorithm> //For std::max.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "Models.h" //The model objects being evaluated.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "FunctionObject.h" //Initial parameters of the models.
+#include "Check.h" //Checks of the tests.
+
+//The analytic gradient of Chi2Covariance, which MIGRAD uses instead of its own finite differences, is compared
+//with central differences of the chi-square, at the initial parameters and at a point away from them. The
+//derivatives ModelGradFCN gives one coordinate at a time must be the same numbers as the whole gradient.
+int main()
+{
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  Settings->Set("FitThreads", "1");
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("WarmStart", "");
+  std::map<std::string, RecipeResult> Recipes; //Instead of the fit logs, which may not exist.
+  Recipes["NRTY0"].Parameters = {10, 0.01};
+  Recipes["NRTY0"].Covariance = {1, 0, 0, 1e-6};
+  Recipes["ERTY0"].Parameters = {51.3};
+  Recipes["ERTY0"].Covariance = {0.01};
+  const std::vector< std::pair<std::string, unsigned int> > Models = {{"NRQY", 0}, {"ERQY", 1}};
+  const double Tolerance(1e-4); //Relative to the largest component of the gradient; a wrong term is off by far more.
+
+  for(unsigned int m(0); m < Models.size(); ++m)
+  {
+    std::string Name(Models.at(m).first + std::to_string(Models.at(m).second));
+    std::shared_ptr<const DataObject> Data(NESTModel::BasicModel::LoadData(Settings, Models.at(m).first, Models.at(m).second, Recipes));
+    NESTModel::BasicModel Model(Models.at(m).first, Models.at(m).second, Settings, Data);
+    bool Defined(false);
+    FunctionObject Definition(Settings->Query("FunctionDefinitions"), Models.at(m).first, Models.at(m).second, Defined);
+    CHECK(Defined && Model.IsDefined() && Model.HasGradient());
+    if(!Defined || !Model.IsDefined() || !Model.HasGradient()) continue;
+    NESTModel::ModelGradFCN FCN(Model);
+    std::vector<double> Initial(Definition.GetParameters());
+    std::vector<double> Moved(Initial);
+    for(unsigned int i(0); i < Moved.size(); ++i) Moved[i] *= i % 2 ? 1.05 : 0.97;
+    const std::vector<double>* Points[] = {&Initial, &Moved};
+    for(unsigned int k(0); k < 2; ++k)
+    {
+      std::vector<double> p(*Points[k]), Gradient(p.size());
+      double Value(Model.Chi2Covariance(p.data(), Gradient.data()));
+      CHECK(Value == Model.Chi2Covariance(p.data()));
+      double Largest(0), Error(0);
+      for(unsigned int i(0); i < p.size(); ++i) Largest = std::max(Largest, std::fabs(Gradient[i]));
+      for(unsigned int i(0); i < p.size(); ++i)
+      {
+	std::vector<double> Up(p), Down(p);
+	double Step(1e-6*std::max(std::fabs(p[i]), 1e-3));
+	Up[i] += Step;
+	Down[i] -= Step;
+	double Difference((Model.Chi2Covariance(Up.data()) - Model.Chi2Covariance(Down.data()))/(Up[i] - Down[i]));
+	Error = std::max(Error, std::fabs(Gradient[i] - Difference)/std::max(Largest, 1e-12));
+	CHECK(FCN.Derivative(p.data(), i) == Gradient[i]);
+      }
+      std::cout << Name << ": the gradient differs from central differences by " << Error << " relative, at point " << k << "." << std::endl;
+      CHECK(Error < Tolerance);
+    }
+  }
+  return CheckFailures();
+}
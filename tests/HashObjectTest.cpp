@@ -0,0 +1,51 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <fstream> //Writes the file being hashed.
+#include <cstdio> //For std::remove.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "HashObject.h" //The hash being checked.
+#include "Check.h" //Checks of the tests.
+
+//The hashes name the cached fits and data, so they must be the published FNV-1a values, the same in every run
+//and on every standard library, and they must tell apart inputs that only differ in where the pieces split.
+int main()
+{
+  HashObject Empty;
+  CHECK(Empty.Get() == 0xcbf29ce484222325ULL && Empty.GetHex() == "cbf29ce484222325");
+  HashObject Bytes;
+  Bytes.Add("foobar", 6);
+  CHECK(Bytes.Get() == 0x85944171f73967e8ULL);
+
+  HashObject First, Second;
+  First.Add(std::string("ab"));
+  First.Add(std::string("c"));
+  Second.Add(std::string("a"));
+  Second.Add(std::string("bc"));
+  CHECK(First.Get() != Second.Get());
+
+  HashObject Zero, NegativeZero;
+  Zero.Add(std::vector<double>{0.0});
+  NegativeZero.Add(std::vector<double>{-0.0});
+  CHECK(Zero.Get() != NegativeZero.Get()); //Exact bits.
+
+  const std::string Name("/tmp/HashObjectTest" + std::to_string(getpid()));
+  {
+    std::ofstream Output(Name);
+    Output << "1,2,3\n";
+  }
+  HashObject File, Text, Missing, MissingText;
+  CHECK(File.AddFile(Name));
+  Text.Add(std::string("1,2,3\n"));
+  CHECK(File.Get() == Text.Get());
+  std::remove(Name.c_str());
+  CHECK(!Missing.AddFile(Name));
+  MissingText.Add(std::string());
+  CHECK(Missing.Get() == MissingText.Get() && Missing.Get() != Empty.Get());
+  return CheckFailures();
+}
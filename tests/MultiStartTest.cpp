@@ -0,0 +1,80 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <cmath> //For std::floor and std::fabs.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "Models.h" //The model objects whose starts are sampled.
+#include "DataObject.h" //Data sets of the models.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "FunctionObject.h" //Initial parameters and limits of the models.
+#include "Check.h" //Checks of the tests.
+
+namespace NESTModel
+{
+  struct MultiStartTest
+  {
+    static std::vector< std::vector<double> > SampleStarts(BasicModel& Model, unsigned int NStarts) { return Model.SampleStarts(NStarts); }
+  };
+}
+
+//A multi-start fit must be reproducible: the starts only depend on MultiStartSeed. The first start is P, and the
+//others are a Latin hypercube, so every parameter uses each of the NStarts-1 strata of its range exactly once.
+//NRQY4 has a limited parameter ([3], in [0, 100]) and unlimited ones. Run in the top level directory.
+int main()
+{
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  Settings->Set("FitThreads", "1");
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("WarmStart", "");
+  Settings->Set("MultiStartSeed", "2718");
+  std::map<std::string, RecipeResult> Recipes; //Instead of the fit logs, which may not exist.
+  Recipes["NRTY0"].Parameters = {10, 0.01};
+  Recipes["NRTY0"].Covariance = {1, 0, 0, 1e-6};
+  std::shared_ptr<const DataObject> Data(NESTModel::BasicModel::LoadData(Settings, "NRQY", 4, Recipes));
+  NESTModel::BasicModel Model("NRQY", 4, Settings, Data);
+  NESTModel::BasicModel Other("NRQY", 4, Settings, Data);
+  bool Defined(false);
+  FunctionObject Definition(Settings->Query("FunctionDefinitions"), "NRQY", 4, Defined);
+  CHECK(Model.IsDefined() && Defined);
+  if(!Model.IsDefined() || !Defined) return CheckFailures();
+
+  const unsigned int NStarts(17);
+  std::vector< std::vector<double> > Starts(NESTModel::MultiStartTest::SampleStarts(Model, NStarts));
+  CHECK(Starts == NESTModel::MultiStartTest::SampleStarts(Model, NStarts));
+  CHECK(Starts == NESTModel::MultiStartTest::SampleStarts(Other, NStarts));
+  CHECK(Starts.size() == NStarts);
+  if(Starts.size() != NStarts) return CheckFailures();
+  CHECK(Starts[0] == Definition.GetParameters());
+
+  const std::vector<double>& P(Definition.GetParameters());
+  double Width(std::stod(Settings->Query("MultiStartWidth")));
+  for(unsigned int i(0); i < P.size(); ++i)
+  {
+    double Low(Definition.GetLimitsLow().at(i)), High(Definition.GetLimitsHigh().at(i));
+    if(Low == 0 && High == 0)
+    {
+      Low = P[i] - Width*(std::fabs(P[i]) + Definition.GetStepSizes().at(i));
+      High = P[i] + Width*(std::fabs(P[i]) + Definition.GetStepSizes().at(i));
+    }
+    std::vector<unsigned int> Used(NStarts-1, 0);
+    for(unsigned int s(1); s < NStarts; ++s)
+    {
+      CHECK(Starts[s].size() == P.size());
+      double Value(Starts[s].at(i));
+      CHECK(Value >= Low && Value <= High);
+      int Stratum(std::floor((Value - Low)/(High - Low)*(NStarts-1)));
+      CHECK(Stratum >= 0 && Stratum < static_cast<int>(NStarts-1));
+      if(Stratum >= 0 && Stratum < static_cast<int>(NStarts-1)) ++Used[Stratum];
+    }
+    for(unsigned int k(0); k < Used.size(); ++k) CHECK(Used[k] == 1);
+  }
+
+  Settings->Set("MultiStartSeed", "3141");
+  CHECK(Starts != NESTModel::MultiStartTest::SampleStarts(Model, NStarts));
+  return CheckFailures();
+}
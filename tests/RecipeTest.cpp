@@ -0,0 +1,78 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <fstream> //Writes the log of the recipe model and a changed definitions file.
+#include <iomanip> //Full precision output.
+#include <limits> //For std::numeric_limits.
+#include <cstdlib> //For std::system.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <stdlib.h> //For mkdtemp.
+#include <unistd.h> //For getcwd and chdir.
+
+//Custom includes.
+#include "DataObject.h" //Converts the data sets with the recipes.
+#include "Check.h" //Checks of the tests.
+
+//A chain passes the fit of a recipe model to the models using it in memory, instead of through its log. Both
+//must give the same converted data and covariance, to the last bit: the log is written with max_digits10, and
+//read back exactly. The log is written in a temporary directory, so that the logs of real fits are left alone.
+//The recipe functions are those of the definitions file the data is given.
+//Run in the top level directory.
+int main()
+{
+  char Buffer[4096];
+  CHECK(getcwd(Buffer, sizeof(Buffer)) != nullptr);
+  std::string Source(Buffer);
+  char Directory[] = "/tmp/RecipeTest.XXXXXX";
+  CHECK(mkdtemp(Directory) != nullptr);
+  CHECK(chdir(Directory) == 0);
+
+  RecipeResult Fit;
+  Fit.Parameters = {10.123456789012345, 0.0123456789012345678};
+  Fit.Covariance = {0.9876543210987654, 1.0/3*1e-4, 1.0/3*1e-4, 1.0/7*1e-6};
+  std::ofstream Log("NRTY0Log.txt"); //As written by BasicModel::SaveParameters().
+  Log << std::setprecision(std::numeric_limits<double>::max_digits10);
+  Log << Fit.Parameters[0] << "," << Fit.Parameters[1] << std::endl;
+  Log << Fit.Covariance[0] << "," << Fit.Covariance[1] << std::endl << Fit.Covariance[2] << "," << Fit.Covariance[3] << std::endl;
+  Log.close();
+
+  std::map<std::string, RecipeResult> InMemory;
+  InMemory["NRTY0"] = Fit;
+  const std::vector<std::string> Sets = {Source + "/NRChargeYield", Source + "/NRLightYield"};
+  const std::vector<std::string> Recipes = {".", "NRTY0"};
+  const std::string Definitions(Source + "/ModelDefinitions.txt");
+  DataObject FromLog(Sets, Recipes, 0.1, 0.05, 0.05, 10, Definitions);
+  DataObject FromMemory(Sets, Recipes, 0.1, 0.05, 0.05, 10, Definitions, "", "c++", InMemory);
+  CHECK(FromLog.IsValid() && FromMemory.IsValid());
+  CHECK(!FromLog.GetDataZ().empty());
+  CHECK(FromLog.GetDataX() == FromMemory.GetDataX());
+  CHECK(FromLog.GetDataZ() == FromMemory.GetDataZ());
+  CHECK(FromLog.GetDataZErrLow() == FromMemory.GetDataZErrLow());
+  const std::vector<CovarianceBlock>& LogBlocks(FromLog.GetCovarianceBlocks()), MemoryBlocks(FromMemory.GetCovarianceBlocks());
+  CHECK(LogBlocks.size() == 2 && MemoryBlocks.size() == 2);
+  for(unsigned int b(0); b < LogBlocks.size() && b < MemoryBlocks.size(); ++b)
+  {
+    CHECK(LogBlocks[b].Rank == MemoryBlocks[b].Rank);
+    CHECK(LogBlocks[b].Diagonal == MemoryBlocks[b].Diagonal);
+    CHECK(LogBlocks[b].Factor == MemoryBlocks[b].Factor);
+  }
+  CHECK(LogBlocks.size() == 2 && LogBlocks[1].Rank > 0); //The recipe adds the uncertainty of its parameters.
+
+  //The recipe is the function of the definitions file given, not of ModelDefinitions.txt.
+  std::ifstream Input(Definitions);
+  std::ofstream Changed("Definitions.txt");
+  std::string Line;
+  while(std::getline(Input, Line)) Changed << (Line.compare(0, 7, "NRTYF0:") == 0 ? "NRTYF0:\"[0]+0*[1]*x\"" : Line) << std::endl;
+  Changed.close();
+  DataObject Raw({Source + "/NRLightYield"}, {"."}, 0.1, 0.05, 0.05, 10, Definitions);
+  DataObject Constant({Source + "/NRLightYield"}, {"NRTY0"}, 0.1, 0.05, 0.05, 10, "Definitions.txt", "", "c++", InMemory);
+  CHECK(Constant.IsValid() && Constant.GetDataZ().size() == Raw.GetDataZ().size());
+  for(unsigned int i(0); i < Constant.GetDataZ().size() && i < Raw.GetDataZ().size(); ++i) CHECK(Constant.GetDataZ()[i] == Fit.Parameters[0] - Raw.GetDataZ()[i]);
+
+  CHECK(chdir(Source.c_str()) == 0);
+  std::system(("rm -rf '" + std::string(Directory) + "'").c_str());
+  return CheckFailures();
+}
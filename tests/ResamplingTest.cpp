@@ -0,0 +1,88 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <future> //Replicas drawn on the thread pool.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "ModelResampling.h" //The resampling being checked.
+#include "Models.h" //The nominal model, which is not fit.
+#include "DataObject.h" //Data sets of the model.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "ThreadPool.h" //Draws the replicas concurrently.
+#include "Check.h" //Checks of the tests.
+
+namespace NESTModel
+{
+  struct ResamplingTest
+  {
+    static void SetNominal(ModelResampling& Resampling, std::shared_ptr<BasicModel> Nominal, unsigned long Seed)
+    {
+      Resampling.Nominal = Nominal;
+      Resampling.Seed = Seed;
+    }
+    static std::vector<unsigned int> Multiplicity(ModelResampling& Resampling, unsigned int Replica) { return Resampling.Multiplicity(Replica); }
+  };
+}
+
+//The points a replica uses only depend on the seed and the replica number, whichever thread draws it and however
+//many threads there are, so any replica can be reproduced on its own. A bootstrap replica redraws each data set
+//with its own number of points, and a jackknife replica leaves out exactly one data set. Nothing is fit, and no
+//output is written. Run in the top level directory.
+int main()
+{
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  Settings->Set("FitThreads", "1");
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("WarmStart", "");
+  std::map<std::string, RecipeResult> Recipes; //Instead of the fit logs, which may not exist.
+  Recipes["NRTY0"].Parameters = {10, 0.01};
+  Recipes["NRTY0"].Covariance = {1, 0, 0, 1e-6};
+  std::shared_ptr<NESTModel::BasicModel> Nominal(new NESTModel::BasicModel("NRQY", 0, Settings, NESTModel::BasicModel::LoadData(Settings, "NRQY", 0, Recipes)));
+  CHECK(Nominal->IsDefined());
+  if(!Nominal->IsDefined()) return CheckFailures();
+  const CovarianceObject& Blocks(Nominal->GetCovarianceFactor());
+  CHECK(Blocks.GetNBlocks() == 2);
+
+  const unsigned int NReplicas(32);
+  NESTModel::ModelResampling Serial("NRQY", 0, NESTModel::ModelResampling::Bootstrap, 1), Parallel("NRQY", 0, NESTModel::ModelResampling::Bootstrap, 4);
+  NESTModel::ResamplingTest::SetNominal(Serial, Nominal, 2718);
+  NESTModel::ResamplingTest::SetNominal(Parallel, Nominal, 2718);
+  std::vector< std::vector<unsigned int> > Counts(NReplicas);
+  for(unsigned int r(0); r < NReplicas; ++r) Counts[r] = NESTModel::ResamplingTest::Multiplicity(Serial, r);
+  {
+    ThreadPool Pool(4);
+    std::vector< std::future< std::vector<unsigned int> > > Drawn;
+    for(unsigned int r(NReplicas); r-- > 0;) Drawn.push_back(Pool.Submit([&Parallel, r]() { return NESTModel::ResamplingTest::Multiplicity(Parallel, r); }));
+    for(unsigned int r(0); r < NReplicas; ++r) CHECK(Drawn[r].get() == Counts[NReplicas-1-r]);
+  }
+  for(unsigned int r(0); r < NReplicas; ++r)
+  {
+    CHECK(Counts[r].size() == Blocks.GetN());
+    for(unsigned int b(0); b < Blocks.GetNBlocks() && Counts[r].size() == Blocks.GetN(); ++b)
+    {
+      unsigned int Drawn(0);
+      for(unsigned int i(0); i < Blocks.GetBlockSize(b); ++i) Drawn += Counts[r].at(Blocks.GetBlockOffset(b) + i);
+      CHECK(Drawn == Blocks.GetBlockSize(b));
+    }
+  }
+  CHECK(Counts[0] != Counts[1]);
+  NESTModel::ResamplingTest::SetNominal(Parallel, Nominal, 3141);
+  CHECK(NESTModel::ResamplingTest::Multiplicity(Parallel, 0) != Counts[0]);
+
+  NESTModel::ModelResampling Jackknife("NRQY", 0, NESTModel::ModelResampling::Jackknife, 1);
+  NESTModel::ResamplingTest::SetNominal(Jackknife, Nominal, 2718);
+  for(unsigned int Left(0); Left < Blocks.GetNBlocks(); ++Left)
+  {
+    std::vector<unsigned int> Used(NESTModel::ResamplingTest::Multiplicity(Jackknife, Left));
+    CHECK(Used.size() == Blocks.GetN());
+    for(unsigned int b(0); b < Blocks.GetNBlocks() && Used.size() == Blocks.GetN(); ++b)
+    {
+      for(unsigned int i(0); i < Blocks.GetBlockSize(b); ++i) CHECK(Used.at(Blocks.GetBlockOffset(b) + i) == (b == Left ? 0u : 1u));
+    }
+  }
+  return CheckFailures();
+}
@@ -0,0 +1,66 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <cmath> //For std::round and std::fabs.
+#include <cstdint> //Cell indices.
+#include <iostream> //Basic input and output.
+
+//Custom includes.
+#include "ModelScan.h" //The scan being checked.
+#include "Check.h" //Checks of the tests.
+
+namespace NESTModel
+{
+  struct ScanTest
+  {
+    static void SetGrid(ModelScan& Scan, const std::vector<unsigned int>& Scanned, const std::vector<double>& Low, const std::vector<double>& High, const std::vector<unsigned int>& NPoints)
+    {
+      Scan.Scanned = Scanned;
+      Scan.Low = Low;
+      Scan.High = High;
+      Scan.NPoints = NPoints;
+    }
+    static void CellParameters(ModelScan& Scan, uint64_t Cell, std::vector<double>& p) { Scan.CellParameters(Cell, p); }
+  };
+}
+
+//Readers of Scan_<ModelType><ModelID>.bin find the parameters of a cell from its index alone, as described in
+//ModelScan.h, so the parameters a cell is evaluated at must be those. Every cell of a grid with a parameter of a
+//single point, which stays at its low value, is turned into parameters and back into its index. Nothing is fit.
+//Run in the top level directory.
+int main()
+{
+  NESTModel::ModelScan Scan("NRQY", 0, 1);
+  const std::vector<unsigned int> Scanned = {3, 0, 1};
+  const std::vector<double> Low = {0.1, -2, 5}, High = {0.3, 2, 7};
+  const std::vector<unsigned int> NPoints = {4, 1, 3};
+  NESTModel::ScanTest::SetGrid(Scan, Scanned, Low, High, NPoints);
+  const std::vector<double> BestFit = {10, 20, 30, 40, 50};
+  const uint64_t NCells(4*1*3);
+  std::vector<bool> Seen(NCells, false);
+  for(uint64_t Cell(0); Cell < NCells; ++Cell)
+  {
+    std::vector<double> p(BestFit);
+    NESTModel::ScanTest::CellParameters(Scan, Cell, p);
+    CHECK(p[2] == BestFit[2] && p[4] == BestFit[4]); //Not scanned.
+    uint64_t Index(0), Stride(1);
+    uint64_t Rest(Cell);
+    for(unsigned int d(0); d < Scanned.size(); ++d)
+    {
+      unsigned int k(Rest % NPoints[d]);
+      Rest /= NPoints[d];
+      double Expected(NPoints[d] > 1 ? Low[d] + (High[d] - Low[d])*k/(NPoints[d] - 1) : Low[d]);
+      double Value(p[Scanned[d]]);
+      CHECK(Value == Expected);
+      if(k == 0) CHECK(Value == Low[d]);
+      if(k + 1 == NPoints[d] && NPoints[d] > 1) CHECK(std::fabs(Value - High[d]) <= 1e-15*std::fabs(High[d]));
+      unsigned int Found(NPoints[d] > 1 ? std::round((Value - Low[d])/(High[d] - Low[d])*(NPoints[d] - 1)) : 0);
+      Index += Found*Stride;
+      Stride *= NPoints[d];
+    }
+    CHECK(Index == Cell);
+    if(Index < NCells) Seen[Index] = true;
+  }
+  for(uint64_t Cell(0); Cell < NCells; ++Cell) CHECK(Seen[Cell]);
+  return CheckFailures();
+}
@@ -0,0 +1,81 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <map> //STL map.
+#include <memory> //For using shared_ptr.
+#include <fstream> //Writes the generated data set.
+#include <random> //Values of the generated data set.
+#include <cstdio> //For std::remove.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <unistd.h> //For getpid.
+
+//Custom includes.
+#include "Models.h" //The model objects being evaluated.
+#include "DataObject.h" //Data sets of the models.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "FunctionObject.h" //Initial parameters of the models.
+#include "Check.h" //Checks of the tests.
+
+//The chi-square of one fit is split into chunks of BasicModel::ChunkSize points and into covariance blocks that
+//run on FitThreads threads, and every sum is taken in an order that does not depend on the number of threads.
+//So the chi-square and its gradient must be bit-identical with 1, 2 and 8 threads. The included data sets are
+//smaller than one chunk, so a generated set of several chunks is fit together with them, with a recipe on it.
+int main()
+{
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("WarmStart", "");
+  std::map<std::string, RecipeResult> Recipes; //Instead of the fit logs, which may not exist.
+  Recipes["NRTY0"].Parameters = {10, 0.01};
+  Recipes["NRTY0"].Covariance = {1, 0, 0, 1e-6};
+
+  //Rows of energy, its lower and upper uncertainty, field, its uncertainties, yield and its uncertainties.
+  const std::string Generated("/tmp/ThreadDeterminismTestSet" + std::to_string(getpid()));
+  std::ofstream Output(Generated + ".csv");
+  std::mt19937_64 Engine(2718);
+  std::uniform_real_distribution<double> Unit(0, 1);
+  const unsigned int NGenerated(5*NESTModel::BasicModel::ChunkSize/2);
+  for(unsigned int i(0); i < NGenerated; ++i)
+  {
+    double Energy(1 + 99*Unit(Engine)), Field(50 + 950*Unit(Engine)), Yield(2 + 6*Unit(Engine));
+    Output << Energy << ",0.5,0.5," << Field << ",0,0," << Yield << "," << 0.1*Yield << "," << 0.1*Yield << "\n";
+  }
+  Output.close();
+  std::shared_ptr<const DataObject> Data(new DataObject({"NRChargeYield", "NRLightYield", Generated}, {".", "NRTY0", "NRTY0"},
+							 std::stod(Settings->Query("DefaultYieldUncertainty")), std::stod(Settings->Query("DefaultEnergyUncertainty")),
+							 std::stod(Settings->Query("DefaultEnergyUncertainty")), std::stod(Settings->Query("LowField")),
+							 Settings->Query("FunctionDefinitions"), "", Settings->Query("FormulaCompiler"), Recipes, false));
+  std::remove((Generated + ".csv").c_str());
+
+  bool Defined(false);
+  FunctionObject Definition(Settings->Query("FunctionDefinitions"), "NRQY", 0, Defined);
+  CHECK(Defined);
+  if(!Defined) return CheckFailures();
+  std::vector<double> p(Definition.GetParameters());
+  const unsigned int Threads[] = {1, 2, 8};
+  double Chi2[3], Chi2Covariance[3];
+  std::vector<double> Gradients[3];
+  for(unsigned int t(0); t < 3; ++t)
+  {
+    Settings->Set("FitThreads", std::to_string(Threads[t]));
+    NESTModel::BasicModel Model("NRQY", 0, Settings, Data);
+    CHECK(Model.IsDefined() && Model.HasGradient());
+    if(!Model.IsDefined() || !Model.HasGradient()) return CheckFailures();
+    Gradients[t].resize(p.size());
+    Chi2[t] = Model.Chi2(p.data());
+    Chi2Covariance[t] = Model.Chi2Covariance(p.data(), Gradients[t].data());
+    CHECK(Chi2Covariance[t] == Model.Chi2Covariance(p.data()));
+    std::cout.precision(17);
+    std::cout << Threads[t] << " threads: Chi2 " << Chi2[t] << ", Chi2Covariance " << Chi2Covariance[t] << "." << std::endl;
+  }
+  for(unsigned int t(1); t < 3; ++t)
+  {
+    CHECK(Chi2[t] == Chi2[0]);
+    CHECK(Chi2Covariance[t] == Chi2Covariance[0]);
+    CHECK(Gradients[t] == Gradients[0]);
+  }
+  return CheckFailures();
+}
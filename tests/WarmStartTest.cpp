@@ -0,0 +1,87 @@
+//C++ includes.
+#include <string> //Basic string.
+#include <vector> //STL vector.
+#include <memory> //For using shared_ptr.
+#include <fstream> //Writes the definitions of the test models.
+#include <cmath> //For std::fabs.
+#include <cstdlib> //For std::system.
+#include <iostream> //Basic input and output.
+
+//POSIX includes.
+#include <stdlib.h> //For mkdtemp.
+#include <unistd.h> //For getcwd and chdir.
+
+//Custom includes.
+#include "Models.h" //The models being fit.
+#include "SettingsObject.h" //Modularizes the input of settings from a .txt file.
+#include "Check.h" //Checks of the tests.
+
+//A fit warm started from the log of an earlier fit of the same data must reach the same minimum in fewer calls,
+//whether the log is the model's own ("log") or that of another model with as many parameters. A log with another
+//number of parameters is not used, and the fit is then the same as from P. The definitions and logs are written
+//in a temporary directory. Run in the top level directory.
+int main()
+{
+  char Buffer[4096];
+  CHECK(getcwd(Buffer, sizeof(Buffer)) != nullptr);
+  std::string Source(Buffer);
+  std::shared_ptr<SettingsObject> Settings(new SettingsObject("Settings.txt"));
+  char Directory[] = "/tmp/WarmStartTest.XXXXXX";
+  CHECK(mkdtemp(Directory) != nullptr);
+  CHECK(chdir(Directory) == 0); //The logs are read from and written to the current directory.
+  std::ofstream Output("Definitions.txt");
+  Output << "WSTYSets:\"" << Source << "/NRTotalYield\"" << std::endl;
+  Output << "WSTYRecipes:\".\"" << std::endl;
+  for(unsigned int ID(0); ID < 2; ++ID)
+  {
+    Output << "WSTYF" << ID << ":\"[0]*TMath::Power(x/10,[1])\"" << std::endl;
+    Output << "WSTYP" << ID << ":\"5,0.5\"" << std::endl;
+    Output << "WSTYLL" << ID << ":\"0,0\"" << std::endl;
+    Output << "WSTYLH" << ID << ":\"0,0\"" << std::endl;
+    Output << "WSTYS" << ID << ":\"1,0.1\"" << std::endl;
+  }
+  Output << "WSTYF2:\"[0]+[1]*x+[2]*x*x\"" << std::endl;
+  Output << "WSTYP2:\"10,0,0\"" << std::endl;
+  Output << "WSTYLL2:\"0,0,0\"" << std::endl;
+  Output << "WSTYLH2:\"0,0,0\"" << std::endl;
+  Output << "WSTYS2:\"0.1,0.01,0.001\"" << std::endl;
+  Output.close();
+  Settings->Set("FunctionDefinitions", "Definitions.txt");
+  Settings->Set("FitThreads", "1");
+  Settings->Set("DataCache", "false");
+  Settings->Set("CompileFormulas", "false");
+  Settings->Set("MultiStarts", "1");
+  Settings->Set("FitCache", "");
+  Settings->Set("FitResults", "false");
+  Settings->Set("FitStore", "");
+  Settings->Set("WarmStart", "");
+
+  NESTModel::BasicModel Cold("WSTY", 0, Settings, nullptr);
+  CHECK(Cold.IsDefined() && Cold.Minimize());
+  if(!Cold.IsConverged()) return CheckFailures();
+  Cold.SaveParameters();
+  NESTModel::BasicModel Other("WSTY", 2, Settings, nullptr);
+  CHECK(Other.IsDefined() && Other.Minimize());
+  Other.SaveParameters();
+
+  const char* Starts[] = {"log", "WSTY0"};
+  for(unsigned int s(0); s < 2; ++s)
+  {
+    Settings->Set("WarmStart", Starts[s]);
+    NESTModel::BasicModel Warm("WSTY", s == 0 ? 0 : 1, Settings, nullptr);
+    CHECK(Warm.IsDefined() && Warm.Minimize());
+    CHECK(std::fabs(Warm.GetChisquare() - Cold.GetChisquare()) <= 1e-6*Cold.GetChisquare());
+    for(unsigned int i(0); i < 2 && Warm.IsConverged(); ++i) CHECK(std::fabs(Warm.GetParameters().at(i) - Cold.GetParameters().at(i)) <= 1e-2*Cold.GetParameterErrors().at(i));
+    std::cout << "From " << Starts[s] << ": " << Warm.GetNCalls() << " calls instead of " << Cold.GetNCalls() << "." << std::endl;
+    CHECK(Warm.GetNCalls() < Cold.GetNCalls());
+  }
+
+  Settings->Set("WarmStart", "WSTY2"); //Three parameters, so P is used.
+  NESTModel::BasicModel Mismatched("WSTY", 1, Settings, nullptr);
+  CHECK(Mismatched.IsDefined() && Mismatched.Minimize());
+  CHECK(Mismatched.GetChisquare() == Cold.GetChisquare() && Mismatched.GetParameters() == Cold.GetParameters() && Mismatched.GetNCalls() == Cold.GetNCalls());
+
+  CHECK(chdir(Source.c_str()) == 0);
+  std::system(("rm -rf '" + std::string(Directory) + "'").c_str());
+  return CheckFailures();
+}